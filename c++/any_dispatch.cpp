@@ -0,0 +1,116 @@
+/* Dispatching std::any visitors by a table indexed by dense type ids compared
+ * to std::unordered_map<std::type_index, std::function> used in std_any.cpp
+ *
+ * Usage: any_dispatch [values [repeat]]
+ *
+ * Compile with C++20 or higher
+ */
+
+#include "any_dispatch.hpp"
+#include "any_visitor.hpp"
+#include "bench.hpp"
+
+#include <any>
+#include <cstdlib>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <typeindex>
+#include <type_traits>
+#include <typeinfo>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+using any_dispatch::dispatcher;
+using any_dispatch::typed_any;
+
+template <size_t I> struct data {
+    unsigned long long v = I;
+};
+
+unsigned long long sum = 0;
+
+void visit(const any_visitor_map& visitors, const std::any& a)
+{
+    if (auto it = visitors.find(std::type_index(a.type()));
+        it != visitors.end())
+    {
+        it->second(a);
+    } else
+        ++sum;
+}
+
+auto add_v = [](const std::any&, const auto& v) { sum += v.v; };
+
+template <size_t ...I> any_visitor_map make_map(std::index_sequence<I...>)
+{
+    return {make_any_visitor<data<I>>(add_v)...};
+}
+
+template <size_t ...I> dispatcher make_dispatcher(std::index_sequence<I...>)
+{
+    dispatcher d{[](const std::any&) { ++sum; }};
+    (..., d.add<data<I>>(add_v));
+    return d;
+}
+
+template <size_t ...I>
+std::vector<typed_any> make_values(std::index_sequence<I...>, size_t n)
+{
+    using make_t = typed_any (*)();
+    std::vector<make_t> make{[]{ return typed_any(data<I>{}); }...};
+    std::mt19937 rnd{};
+    std::uniform_int_distribution<size_t> dist(0, sizeof...(I) - 1);
+    std::vector<typed_any> values;
+    values.reserve(n);
+    for (size_t i = 0; i < n; ++i)
+        values.push_back(make[dist(rnd)]());
+    return values;
+}
+
+template <size_t N> void run(size_t n, size_t repeat)
+{
+    auto idx = std::make_index_sequence<N>{};
+    auto map = make_map(idx);
+    auto disp = make_dispatcher(idx);
+    auto values = make_values(idx, n);
+    auto types = " types=" + std::to_string(N);
+    double ns_map = bench::ns_per_op("unordered_map" + types, repeat,
+                                     [&](size_t) {
+        for (auto& v: values)
+            visit(map, v.any());
+    }) / n;
+    bench::do_not_optimize(sum);
+    double ns_disp = bench::ns_per_op("dispatcher" + types, repeat,
+                                      [&](size_t) {
+        for (auto& v: values)
+            disp(v);
+    }) / n;
+    bench::do_not_optimize(sum);
+    std::cout << "types=" << std::setw(3) << N << std::fixed <<
+        std::setprecision(2) << " unordered_map ns/dispatch=" << ns_map <<
+        " dispatcher ns/dispatch=" << ns_disp << std::defaultfloat <<
+        std::endl;
+}
+
+int main(int argc, char* argv[])
+{
+    size_t n = 1'000'000;
+    size_t repeat = 10;
+    if (argc > 1)
+        n = std::stoull(argv[1]);
+    if (argc > 2)
+        repeat = std::stoull(argv[2]);
+    run<2>(n, repeat);
+    run<5>(n, repeat);
+    run<10>(n, repeat);
+    run<20>(n, repeat);
+    run<50>(n, repeat);
+    run<100>(n, repeat);
+    run<200>(n, repeat);
+    std::cout << "sum=" << sum << std::endl;
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,87 @@
+#pragma once
+
+/* Dispatching visitors of std::any by dense type ids in constant time
+ *
+ * Each type gets a small integer id on first use. A value is stored in
+ * typed_any, which is std::any together with the id of the stored type.
+ * Dispatching is then indexing a table of function pointers by the id,
+ * without hashing std::type_index and without calling std::function.
+ *
+ * Compile with C++20 or higher
+ */
+
+#include <any>
+#include <atomic>
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace any_dispatch {
+
+inline size_t next_type_id()
+{
+    static std::atomic<size_t> next{0};
+    return next.fetch_add(1, std::memory_order_relaxed);
+}
+
+// A dense id of type T, void denotes no value
+template <class T> size_t type_id()
+{
+    static const size_t id = next_type_id();
+    return id;
+}
+
+class typed_any {
+public:
+    typed_any() noexcept: id(type_id<void>()) {}
+    template <class T> requires (!std::is_same_v<std::decay_t<T>, typed_any>)
+    typed_any(T&& v):
+        value(std::forward<T>(v)), id(type_id<std::decay_t<T>>()) {}
+    const std::any& any() const noexcept {
+        return value;
+    }
+    size_t type() const noexcept {
+        return id;
+    }
+    void reset() noexcept {
+        value.reset();
+        id = type_id<void>();
+    }
+private:
+    std::any value;
+    size_t id;
+};
+
+// Visitors are stateless callables, called as f(a) for void (no value) and
+// f(a, v) for a registered type T, where v is the value of type const T&.
+// The fallback visitor is called as f(a) for unregistered types.
+class dispatcher {
+public:
+    using handler = void (*)(const std::any&);
+    explicit dispatcher(handler fallback) noexcept: fallback(fallback) {}
+    template <class T, class F> dispatcher& add(F) {
+        static_assert(std::is_empty_v<F> &&
+                      std::is_default_constructible_v<F>,
+                      "visitor must be stateless");
+        size_t id = type_id<T>();
+        if (id >= table.size())
+            table.resize(id + 1, fallback);
+        table[id] = [](const std::any& a) {
+            if constexpr (std::is_void_v<T>)
+                F{}(a);
+            else
+                F{}(a, *std::any_cast<const T>(&a));
+        };
+        return *this;
+    }
+    void operator()(const typed_any& a) const {
+        size_t id = a.type();
+        (id < table.size() ? table[id] : fallback)(a.any());
+    }
+private:
+    std::vector<handler> table;
+    handler fallback;
+};
+
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+/* Visitors of std::any stored in std::unordered_map by std::type_index
+ *
+ * make_any_visitor<T>(f) creates an entry of the map, which calls f(a) if T
+ * is void (no value), or f(a, v), where v is the value of type const T&.
+ *
+ * Compile with C++17 or higher
+ */
+
+#include <any>
+#include <functional>
+#include <type_traits>
+#include <typeindex>
+#include <typeinfo>
+#include <unordered_map>
+#include <utility>
+
+using any_visitor_map =
+    std::unordered_map<std::type_index, std::function<void(const std::any&)>>;
+
+template <class T, class F>
+std::pair<const std::type_index, std::function<void(const std::any&)>>
+make_any_visitor(const F& f)
+{
+    return {
+        std::type_index(typeid(T)),
+        [f](const std::any & a) {
+            if constexpr (std::is_void_v<T>)
+                f(a);
+            else
+                f(a, std::any_cast<const T&>(a));
+        }
+    };
+}
@@ -0,0 +1,67 @@
+/* Throughput of construction, assignment, and copying of std::any and
+ * basic_any with various sizes of the internal buffer
+ *
+ * Usage: basic_any [iterations]
+ *
+ * Compile with C++20 or higher
+ */
+
+#include "basic_any.hpp"
+#include "bench.hpp"
+
+#include <any>
+#include <array>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <string_view>
+
+template <size_t S> using payload = std::array<char, S>;
+
+template <class Any, size_t S> void run(std::string_view name, size_t n)
+{
+    payload<S> v{};
+    auto c = std::string(name) + " payload=" + std::to_string(S);
+    double construct = bench::ns_per_op(c + " construct", n, [&v](size_t i) {
+        v[0] = char(i);
+        Any a(v);
+        bench::do_not_optimize(a);
+    });
+    Any a;
+    double assign = bench::ns_per_op(c + " assign", n, [&a, &v](size_t i) {
+        v[0] = char(i);
+        a = v;
+        bench::do_not_optimize(a);
+    });
+    double copy = bench::ns_per_op(c + " copy", n, [&a](size_t) {
+        Any c(a);
+        bench::do_not_optimize(c);
+    });
+    std::cout << std::setw(16) << name << " payload=" << std::setw(4) << S <<
+        std::fixed << std::setprecision(2) <<
+        " ns/construct=" << std::setw(6) << construct <<
+        " ns/assign=" << std::setw(6) << assign <<
+        " ns/copy=" << std::setw(6) << copy << std::defaultfloat << std::endl;
+}
+
+template <size_t S> void run_all(size_t n)
+{
+    run<std::any, S>("std::any", n);
+    run<basic_any<16>, S>("basic_any<16>", n);
+    run<basic_any<128>, S>("basic_any<128>", n);
+    run<cow_any<16>, S>("cow_any<16>", n);
+}
+
+int main(int argc, char* argv[])
+{
+    size_t n = 10'000'000;
+    if (argc > 1)
+        n = std::stoull(argv[1]);
+    run_all<8>(n);
+    run_all<16>(n);
+    run_all<64>(n);
+    run_all<128>(n);
+    run_all<1024>(n);
+    return EXIT_SUCCESS;
+}
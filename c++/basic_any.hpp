@@ -0,0 +1,351 @@
+#pragma once
+
+/* A replacement of std::any with configurable size and alignment of the
+ * internal buffer for small objects
+ *
+ * basic_any<InlineSize, Align> has the same interface as std::any. An object
+ * is stored in the internal buffer if it fits into InlineSize bytes (at least
+ * sizeof(void*)), its alignment divides Align, and it is nothrow move
+ * constructible. Otherwise, it is allocated on the heap. Variants:
+ * move_only_any does not require copyable objects and is not copyable itself.
+ * cow_any shares copies of heap allocated objects and copies an object only
+ * when a non-const reference to it is requested and it is shared.
+ *
+ * Compile with C++20 or higher
+ */
+
+#include <algorithm>
+#include <any>
+#include <atomic>
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <typeinfo>
+#include <utility>
+
+enum class any_copy {
+    copy, // copyable like std::any
+    move_only, // only movable
+    cow, // copyable, copy on write for objects not stored inline
+};
+
+namespace basic_any_detail {
+
+template <class T> inline constexpr bool is_in_place_type_v = false;
+template <class T>
+inline constexpr bool is_in_place_type_v<std::in_place_type_t<T>> = true;
+
+}
+
+template <size_t InlineSize = 2 * sizeof(void*),
+          size_t Align = alignof(std::max_align_t),
+          any_copy Copy = any_copy::copy>
+class basic_any {
+public:
+    static constexpr size_t inline_size = std::max(InlineSize, sizeof(void*));
+    static constexpr size_t inline_align = Align;
+    template <class T> static constexpr bool fits_inline =
+        sizeof(T) <= inline_size && Align % alignof(T) == 0 &&
+        std::is_nothrow_move_constructible_v<T>;
+    template <class T> static constexpr bool storable =
+        Copy == any_copy::move_only ? std::is_move_constructible_v<T> :
+            std::is_copy_constructible_v<T>;
+    constexpr basic_any() noexcept = default;
+    basic_any(const basic_any& o) requires (Copy != any_copy::move_only) {
+        if (o.mgr) {
+            arg a{.any = this};
+            o.mgr(op::copy, const_cast<basic_any*>(&o), &a);
+            mgr = o.mgr;
+        }
+    }
+    basic_any(basic_any&& o) noexcept {
+        steal(o);
+    }
+    template <class T, class D = std::decay_t<T>>
+        requires (!std::is_same_v<D, basic_any> &&
+                  !basic_any_detail::is_in_place_type_v<D> && storable<D>)
+    basic_any(T&& v) {
+        create<D>(std::forward<T>(v));
+    }
+    template <class T, class ...A>
+        requires (storable<T> && std::is_constructible_v<T, A...>)
+    explicit basic_any(std::in_place_type_t<T>, A&& ...a) {
+        create<T>(std::forward<A>(a)...);
+    }
+    ~basic_any() {
+        reset();
+    }
+    basic_any& operator=(const basic_any& o)
+        requires (Copy != any_copy::move_only)
+    {
+        *this = basic_any(o);
+        return *this;
+    }
+    basic_any& operator=(basic_any&& o) noexcept {
+        reset();
+        steal(o);
+        return *this;
+    }
+    template <class T, class D = std::decay_t<T>>
+        requires (!std::is_same_v<D, basic_any> && storable<D>)
+    basic_any& operator=(T&& v) {
+        *this = basic_any(std::forward<T>(v));
+        return *this;
+    }
+    template <class T, class ...A>
+        requires (storable<std::decay_t<T>> &&
+                  std::is_constructible_v<std::decay_t<T>, A...>)
+    std::decay_t<T>& emplace(A&& ...a) {
+        reset();
+        return create<std::decay_t<T>>(std::forward<A>(a)...);
+    }
+    void reset() noexcept {
+        if (mgr) {
+            mgr(op::destroy, this, nullptr);
+            mgr = nullptr;
+        }
+    }
+    void swap(basic_any& o) noexcept {
+        basic_any t(std::move(o));
+        o.steal(*this);
+        steal(t);
+    }
+    bool has_value() const noexcept {
+        return mgr != nullptr;
+    }
+    const std::type_info& type() const noexcept {
+        if (!mgr)
+            return typeid(void);
+        arg a;
+        mgr(op::type, const_cast<basic_any*>(this), &a);
+        return *a.type;
+    }
+    // Used by any_cast, returns nullptr if the stored object is not of type T
+    template <class T> const T* get() const noexcept {
+        return static_cast<const T*>(get_ptr<T>(op::get));
+    }
+    // Unshares the stored object of cow_any
+    template <class T> T* get() noexcept {
+        return static_cast<T*>(get_ptr<T>(op::get_mut));
+    }
+private:
+    enum class op { destroy, copy, move, type, get, get_mut };
+    union arg {
+        basic_any* any;
+        const std::type_info* type;
+        void* ptr;
+    };
+    using manager = void (*)(op, basic_any*, arg*);
+    template <class T> struct inline_handler {
+        static T* ptr(basic_any* self) noexcept {
+            return std::launder(reinterpret_cast<T*>(self->s.buf));
+        }
+        template <class ...A> static T& create(basic_any* self, A&& ...a) {
+            return *::new (self->s.buf) T(std::forward<A>(a)...);
+        }
+        static void manage(op o, basic_any* self, arg* a) {
+            switch (o) {
+            case op::destroy:
+                ptr(self)->~T();
+                break;
+            case op::copy:
+                if constexpr (Copy != any_copy::move_only)
+                    create(a->any, *ptr(self));
+                break;
+            case op::move:
+                create(a->any, std::move(*ptr(self)));
+                ptr(self)->~T();
+                break;
+            case op::type:
+                a->type = &typeid(T);
+                break;
+            case op::get:
+            case op::get_mut:
+                a->ptr = ptr(self);
+                break;
+            }
+        }
+    };
+    template <class T> struct heap_handler {
+        template <class ...A> static T& create(basic_any* self, A&& ...a) {
+            auto p = new T(std::forward<A>(a)...);
+            self->s.ptr = p;
+            return *p;
+        }
+        static void manage(op o, basic_any* self, arg* a) {
+            auto p = static_cast<T*>(self->s.ptr);
+            switch (o) {
+            case op::destroy:
+                delete p;
+                break;
+            case op::copy:
+                if constexpr (Copy != any_copy::move_only)
+                    create(a->any, *p);
+                break;
+            case op::move:
+                a->any->s.ptr = p;
+                break;
+            case op::type:
+                a->type = &typeid(T);
+                break;
+            case op::get:
+            case op::get_mut:
+                a->ptr = p;
+                break;
+            }
+        }
+    };
+    template <class T> struct cow_handler {
+        struct block {
+            template <class ...A> explicit block(A&& ...a):
+                value(std::forward<A>(a)...) {}
+            std::atomic<size_t> refs{1};
+            T value;
+        };
+        template <class ...A> static T& create(basic_any* self, A&& ...a) {
+            auto p = new block(std::forward<A>(a)...);
+            self->s.ptr = p;
+            return p->value;
+        }
+        static void release(block* p) noexcept {
+            if (p->refs.fetch_sub(1, std::memory_order_acq_rel) == 1)
+                delete p;
+        }
+        static void manage(op o, basic_any* self, arg* a) {
+            auto p = static_cast<block*>(self->s.ptr);
+            switch (o) {
+            case op::destroy:
+                release(p);
+                break;
+            case op::copy:
+                p->refs.fetch_add(1, std::memory_order_relaxed);
+                a->any->s.ptr = p;
+                break;
+            case op::move:
+                a->any->s.ptr = p;
+                break;
+            case op::type:
+                a->type = &typeid(T);
+                break;
+            case op::get_mut:
+                if (p->refs.load(std::memory_order_acquire) != 1) {
+                    // Copying may throw, but get() is noexcept, like
+                    // std::any_cast. Failure is reported by nullptr.
+                    try {
+                        auto c = new block(std::as_const(p->value));
+                        release(p);
+                        self->s.ptr = p = c;
+                    } catch (...) {
+                        a->ptr = nullptr;
+                        break;
+                    }
+                }
+                [[fallthrough]];
+            case op::get:
+                a->ptr = &p->value;
+                break;
+            }
+        }
+    };
+    template <class T> using handler =
+        std::conditional_t<fits_inline<T>, inline_handler<T>,
+            std::conditional_t<Copy == any_copy::cow, cow_handler<T>,
+                heap_handler<T>>>;
+    template <class T, class ...A> T& create(A&& ...a) {
+        T& v = handler<T>::create(this, std::forward<A>(a)...);
+        mgr = &handler<T>::manage;
+        return v;
+    }
+    // Moves the value of o to this, which must be empty
+    void steal(basic_any& o) noexcept {
+        if (o.mgr) {
+            arg a{.any = this};
+            o.mgr(op::move, &o, &a);
+            mgr = std::exchange(o.mgr, nullptr);
+        }
+    }
+    template <class T> void* get_ptr(op o) const noexcept {
+        if constexpr (!storable<T>)
+            return nullptr;
+        else {
+            if (!mgr ||
+                (mgr != &handler<T>::manage && type() != typeid(T)))
+            {
+                return nullptr;
+            }
+            arg a;
+            mgr(o, const_cast<basic_any*>(this), &a);
+            return a.ptr;
+        }
+    }
+    union storage {
+        void* ptr;
+        alignas(Align) std::byte buf[inline_size];
+    } s;
+    manager mgr = nullptr;
+};
+
+template <size_t InlineSize = 2 * sizeof(void*),
+          size_t Align = alignof(std::max_align_t)>
+using move_only_any = basic_any<InlineSize, Align, any_copy::move_only>;
+
+template <size_t InlineSize = 2 * sizeof(void*),
+          size_t Align = alignof(std::max_align_t)>
+using cow_any = basic_any<InlineSize, Align, any_copy::cow>;
+
+template <size_t S, size_t A, any_copy C>
+void swap(basic_any<S, A, C>& a, basic_any<S, A, C>& b) noexcept
+{
+    a.swap(b);
+}
+
+template <class T, size_t S, size_t A, any_copy C>
+const T* any_cast(const basic_any<S, A, C>* a) noexcept
+{
+    return a ? a->template get<std::remove_cv_t<T>>() : nullptr;
+}
+
+template <class T, size_t S, size_t A, any_copy C>
+T* any_cast(basic_any<S, A, C>* a) noexcept
+{
+    if (!a)
+        return nullptr;
+    if constexpr (std::is_const_v<T>)
+        return std::as_const(*a).template get<std::remove_cv_t<T>>();
+    else
+        return a->template get<std::remove_cv_t<T>>();
+}
+
+template <class T, size_t S, size_t A, any_copy C>
+T any_cast(const basic_any<S, A, C>& a)
+{
+    using U = std::remove_cvref_t<T>;
+    if (auto p = any_cast<U>(&a))
+        return static_cast<T>(*p);
+    throw std::bad_any_cast{};
+}
+
+// Only a cast to a non-const reference uses the non-const access, which
+// unshares a cow_any. A value or a const reference is taken by the const one.
+template <class T, size_t S, size_t A, any_copy C>
+T any_cast(basic_any<S, A, C>& a)
+{
+    if constexpr (!std::is_lvalue_reference_v<T> ||
+                  std::is_const_v<std::remove_reference_t<T>>)
+    {
+        return any_cast<T>(std::as_const(a));
+    } else {
+        if (auto p = any_cast<std::remove_reference_t<T>>(&a))
+            return static_cast<T>(*p);
+        throw std::bad_any_cast{};
+    }
+}
+
+template <class T, size_t S, size_t A, any_copy C>
+T any_cast(basic_any<S, A, C>&& a)
+{
+    using U = std::remove_cvref_t<T>;
+    if (auto p = any_cast<U>(&a))
+        return static_cast<T>(std::move(*p));
+    throw std::bad_any_cast{};
+}
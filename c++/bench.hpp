@@ -0,0 +1,201 @@
+#pragma once
+
+/* Helpers for measuring run time of small pieces of code
+ *
+ * ns_per_op() runs a measured loop several times and returns the median of
+ * the runs. The runs are controlled by environment variables, read by
+ * options::from_env():
+ * - BENCH_WARMUP: the number of runs discarded before measuring (default 0)
+ * - BENCH_REPEATS: the number of measured runs (default 1)
+ * - BENCH_OUTLIER: runs farther from the median than this number of scaled
+ *   median absolute deviations are rejected (default 3)
+ * - BENCH_JSON: a file, to which a JSON object per line is appended for each
+ *   call of ns_per_op(), with the time in seconds since the Unix epoch, the
+ *   program name, the case name, and the statistics of the runs
+ * With BENCH_REPEATS or BENCH_WARMUP, the measured function must tolerate
+ * being called again for the same values of its argument.
+ *
+ * Compile with C++17 or higher
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdlib>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#if defined(__GLIBC__)
+#include <errno.h>
+#endif
+
+namespace bench {
+
+using clock = std::chrono::steady_clock;
+
+// Prevents the compiler from optimizing out computation of v
+template <class T> inline void do_not_optimize(T&& v)
+{
+    asm volatile("" : : "g"(&v) : "memory");
+}
+
+// Prevents the compiler from assuming anything about the content of memory
+inline void clobber()
+{
+    asm volatile("" : : : "memory");
+}
+
+// Nanoseconds elapsed since start
+inline double ns_since(clock::time_point start)
+{
+    return std::chrono::duration<double, std::nano>(clock::now() - start).
+        count();
+}
+
+struct options {
+    size_t warmup = 0;
+    size_t repeats = 1;
+    double outlier = 3.0;
+    std::string json; // no output if empty
+    static const options& from_env() {
+        static const options opts = [] {
+            options o;
+            if (auto v = std::getenv("BENCH_WARMUP"))
+                o.warmup = std::strtoull(v, nullptr, 10);
+            if (auto v = std::getenv("BENCH_REPEATS"))
+                o.repeats = std::max<size_t>(std::strtoull(v, nullptr, 10), 1);
+            if (auto v = std::getenv("BENCH_OUTLIER"))
+                o.outlier = std::strtod(v, nullptr);
+            if (auto v = std::getenv("BENCH_JSON"))
+                o.json = v;
+            return o;
+        }();
+        return opts;
+    }
+};
+
+// Statistics of runs, in nanoseconds per operation
+struct stats {
+    double median = 0;
+    double mad = 0; // median absolute deviation
+    double min = 0;
+    double max = 0;
+    size_t runs = 0; // accepted
+    size_t rejected = 0; // outliers
+};
+
+inline double median(std::vector<double> v)
+{
+    if (v.empty())
+        return 0;
+    size_t h = v.size() / 2;
+    std::nth_element(v.begin(), v.begin() + h, v.end());
+    if (v.size() % 2)
+        return v[h];
+    return (v[h] + *std::max_element(v.begin(), v.begin() + h)) / 2;
+}
+
+inline double mad(const std::vector<double>& v, double m)
+{
+    std::vector<double> d;
+    d.reserve(v.size());
+    for (auto x: v)
+        d.push_back(std::abs(x - m));
+    return median(std::move(d));
+}
+
+// Rejects samples farther from the median than outlier * 1.4826 * MAD,
+// which is outlier standard deviations for normally distributed samples
+inline stats summarize(const std::vector<double>& samples, double outlier)
+{
+    stats s;
+    if (samples.empty())
+        return s;
+    double m = median(samples);
+    double limit = outlier * 1.4826 * mad(samples, m);
+    std::vector<double> kept;
+    for (auto x: samples)
+        if (std::abs(x - m) <= limit)
+            kept.push_back(x);
+    s.rejected = samples.size() - kept.size();
+    s.runs = kept.size();
+    s.median = median(kept);
+    s.mad = mad(kept, s.median);
+    s.min = *std::min_element(kept.begin(), kept.end());
+    s.max = *std::max_element(kept.begin(), kept.end());
+    return s;
+}
+
+inline std::string_view program_name()
+{
+#if defined(__GLIBC__)
+    return program_invocation_short_name;
+#else
+    return "";
+#endif
+}
+
+// Appends a JSON object to the file opts.json, if set. Safe to call from
+// several threads.
+inline void record(std::string_view name, size_t n, const stats& s,
+                   const options& opts = options::from_env())
+{
+    if (opts.json.empty())
+        return;
+    auto quoted = [](std::string_view v) {
+        std::string r = "\"";
+        for (char c: v) {
+            if (c == '"' || c == '\\')
+                r += '\\';
+            r += c;
+        }
+        return r + '"';
+    };
+    auto now = std::chrono::duration_cast<std::chrono::seconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    static std::mutex mtx;
+    std::lock_guard lock(mtx);
+    std::ofstream os(opts.json, std::ios::app);
+    os << "{\"time\":" << now << ",\"program\":" <<
+        quoted(program_name()) << ",\"case\":" <<
+        quoted(name) << ",\"n\":" << n << ",\"runs\":" << s.runs <<
+        ",\"rejected\":" << s.rejected << ",\"median_ns\":" << s.median <<
+        ",\"mad_ns\":" << s.mad << ",\"min_ns\":" << s.min << ",\"max_ns\":" <<
+        s.max << "}\n";
+}
+
+// Calls f(i) for i = 0, ..., n - 1 in opts.warmup + opts.repeats runs,
+// records statistics of the average times of a call in nanoseconds in the
+// measured runs, and returns them. If n is 0, there is no run, and the
+// statistics are empty.
+template <class F>
+stats measure(std::string_view name, size_t n, F&& f,
+              const options& opts = options::from_env())
+{
+    std::vector<double> samples;
+    for (size_t r = 0; n > 0 && r < opts.warmup + opts.repeats; ++r) {
+        auto start = clock::now();
+        for (size_t i = 0; i < n; ++i)
+            f(i);
+        double ns = ns_since(start) / double(n);
+        if (r >= opts.warmup)
+            samples.push_back(ns);
+    }
+    stats s = summarize(samples, opts.outlier);
+    record(name, n, s, opts);
+    return s;
+}
+
+// Calls f(i) for i = 0, ..., n - 1 and returns the average time of a call in
+// nanoseconds, the median of the runs configured by the environment
+template <class F> double ns_per_op(std::string_view name, size_t n, F&& f)
+{
+    return measure(name, n, f).median;
+}
+
+}
@@ -0,0 +1,94 @@
+/* Cloning whole collections of polymorphic objects from class_clone.hpp by
+ * bulk_clone() into a single arena compared to calling clone() for each
+ * element
+ *
+ * Usage: bulk_clone [max_exponent]
+ *   The number of objects goes from 10^3 to 10^max_exponent (default 7).
+ *
+ * Compile with C++17 or higher
+ */
+
+#include "bench.hpp"
+#include "class_clone.hpp"
+#include "new_delete.hpp"
+
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <vector>
+
+void display(std::string_view method, size_t n, size_t allocs, double ns_clone,
+             double ns_release)
+{
+    std::cout << std::setw(10) << method << " objects=" << std::setw(8) << n <<
+        " allocations=" << std::setw(8) << allocs << std::fixed <<
+        std::setprecision(2) << " Mclones/s=" << 1e3 * n / ns_clone <<
+        " ns/release=" << ns_release / n << std::defaultfloat << std::endl;
+}
+
+void run(size_t n)
+{
+    // sources are created in an arena, too, so that they fit in memory
+    clone_arena src_arena;
+    std::vector<clonable_int*> src;
+    src.reserve(n);
+    for (size_t i = 0; i < n; ++i) {
+        int v = int(i);
+        switch (i % 4) {
+        case 0:
+            src.push_back(clonable_int(v).clone_in(src_arena));
+            break;
+        case 1:
+            src.push_back(clonable_int_str(v, "abc").clone_in(src_arena));
+            break;
+        case 2:
+            src.push_back(clonable_int1(std::tuple{v}).clone_in(src_arena));
+            break;
+        default:
+            src.push_back(clonable_int2(std::tuple{v}).clone_in(src_arena));
+            break;
+        }
+    }
+    {
+        size_t allocs = new_delete::new_count;
+        auto start = bench::clock::now();
+        std::vector<std::shared_ptr<clonable_int>> copies;
+        copies.reserve(n);
+        for (auto p: src)
+            copies.push_back(p->clone());
+        double ns_clone = bench::ns_since(start);
+        allocs = new_delete::new_count - allocs;
+        start = bench::clock::now();
+        copies.clear();
+        copies.shrink_to_fit();
+        display("clone", n, allocs, ns_clone, bench::ns_since(start));
+    }
+    {
+        size_t allocs = new_delete::new_count;
+        auto start = bench::clock::now();
+        auto arena = std::make_unique<clone_arena>();
+        auto copies = bulk_clone(src, *arena);
+        double ns_clone = bench::ns_since(start);
+        allocs = new_delete::new_count - allocs;
+        start = bench::clock::now();
+        copies.clear();
+        copies.shrink_to_fit();
+        arena.reset();
+        display("bulk_clone", n, allocs, ns_clone, bench::ns_since(start));
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    int max_exp = 7;
+    if (argc > 1)
+        max_exp = std::stoi(argv[1]);
+    size_t n = 1000;
+    for (int e = 3; e <= max_exp; ++e, n *= 10)
+        run(n);
+    return EXIT_SUCCESS;
+}
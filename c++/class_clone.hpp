@@ -0,0 +1,325 @@
+#pragma once
+
+/* A polymorphic class hierarchy which implements cloning objects and permits
+ * multiple inheritance.
+ *
+ * Besides clone() returning std::shared_ptr, an object can be cloned without
+ * RTTI and atomic reference counting by clone_unique() returning
+ * std::unique_ptr, by clone_at() into memory supplied by the caller, or by
+ * clone_in() into an arena. An object can be moved by move_to() into memory
+ * supplied by the caller. An object created by clone_at() or move_to() is
+ * destroyed by destroy_at(), which does not need a public destructor.
+ * clonable_base provides clone_at(), move_to(), and destroy_at(), too, for
+ * owners that know only this base.
+ *
+ * Compile with C++17 or higher
+ */
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <iostream>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <typeinfo>
+#include <utility>
+#include <vector>
+
+class clonable_base {
+public:
+    struct layout {
+        size_t size;
+        size_t align;
+        bool nothrow_move;
+    };
+    // Size and alignment of the complete object, required by clone_at() and
+    // move_to()
+    virtual layout clone_layout() const noexcept = 0;
+    clonable_base* clone_at(void* p) const {
+        return subobject(this, clone_at_impl(p));
+    }
+    clonable_base* move_to(void* p) {
+        return subobject(this, move_to_impl(p));
+    }
+    void destroy_at() noexcept {
+        destroy_impl();
+    }
+protected:
+    // Pointers to complete objects of the copy and of the original
+    struct clone_result {
+        void* copy;
+        const void* original;
+    };
+    explicit clonable_base(std::tuple<> = {}) {}
+    virtual ~clonable_base() = default;
+    virtual std::shared_ptr<clonable_base> clone_impl() = 0;
+    virtual clone_result clone_new_impl() const = 0;
+    virtual clone_result clone_at_impl(void* p) const = 0;
+    virtual clone_result move_to_impl(void* p) = 0;
+    virtual void destroy_impl() noexcept = 0;
+    // The copy is a complete object of the same type as the original,
+    // therefore the subobject self has the same offset in both of them. It
+    // selects the correct subobject even if the complete object contains
+    // several subobjects of type T, without dynamic_cast.
+    template <class T>
+    static T* subobject(const T* self, clone_result r) noexcept {
+        auto offset = reinterpret_cast<const char*>(self) -
+            static_cast<const char*>(r.original);
+        return std::launder(
+            reinterpret_cast<T*>(static_cast<char*>(r.copy) + offset));
+    }
+};
+
+template <class D, class B0 = clonable_base, class ...B>
+class clonable: public B0, public B... {
+public:
+    template <class A0, class ...A> explicit clonable(A0&& a0, A&& ...a):
+        B0(std::forward<A0>(a0)), B(std::forward<A>(a))... {}
+    std::shared_ptr<D> clone() {
+        return std::dynamic_pointer_cast<D>(clone_impl());
+    }
+    std::unique_ptr<D> clone_unique() const {
+        return std::unique_ptr<D>(subobject(clone_new_impl()));
+    }
+    // Memory at p must have the size and alignment given by clone_layout().
+    // The caller is responsible for destroying the copy.
+    D* clone_at(void* p) const {
+        return subobject(clone_at_impl(p));
+    }
+    // Like clone_at(), but moves from this object
+    D* move_to(void* p) {
+        return subobject(move_to_impl(p));
+    }
+    // Destroys an object created by clone_at() or move_to()
+    void destroy_at() noexcept {
+        destroy_impl();
+    }
+    // Arena must provide member functions
+    // void* allocate(size_t size, size_t align) and
+    // template <class T> void destroy_later(T* p)
+    template <class Arena> D* clone_in(Arena& arena) const {
+        auto l = clone_layout();
+        D* p = clone_at(arena.allocate(l.size, l.align));
+        arena.destroy_later(p);
+        return p;
+    }
+    clonable_base::layout clone_layout() const noexcept override {
+        return {sizeof(D), alignof(D), std::is_nothrow_move_constructible_v<D>};
+    }
+protected:
+    std::shared_ptr<clonable_base> clone_impl() override {
+        return std::dynamic_pointer_cast<B0>(
+            std::make_shared<D>(dynamic_cast<D&>(*this))
+        );
+    }
+    // D is the most derived class, because clone_*_impl() is overridden in
+    // each class in the hierarchy, hence static_cast is safe. This requires
+    // that every class derives through clonable<D, ...>. A class derived
+    // directly from a concrete clonable class would inherit the overriders
+    // of its base and be sliced, which is checked in debug builds.
+    clonable_base::clone_result clone_new_impl() const override {
+        auto& self = most_derived();
+        return {new D(self), &self};
+    }
+    clonable_base::clone_result clone_at_impl(void* p) const override {
+        auto& self = most_derived();
+        return {::new (p) D(self), &self};
+    }
+    clonable_base::clone_result move_to_impl(void* p) override {
+        auto& self = const_cast<D&>(most_derived());
+        return {::new (p) D(std::move(self)), &self};
+    }
+    void destroy_impl() noexcept override {
+        const_cast<D&>(most_derived()).~D();
+    }
+private:
+    const D& most_derived() const noexcept {
+        assert(typeid(*this) == typeid(D) &&
+               "a clonable class must derive through clonable<D, ...>");
+        return static_cast<const D&>(*this);
+    }
+    D* subobject(clonable_base::clone_result r) const noexcept {
+        return clonable_base::subobject(static_cast<const D*>(this), r);
+    }
+};
+
+class clonable_int: public clonable<clonable_int> {
+public:
+    explicit clonable_int(std::tuple<int> i): clonable_int(std::get<0>(i)) {}
+    explicit clonable_int(int i = {}): clonable(std::tuple<>{}), i(i) {}
+    int i;
+};
+
+inline std::ostream& operator<<(std::ostream& os, const clonable_int& v)
+{
+    return os << v.i;
+}
+
+class clonable_str: public clonable<clonable_str> {
+public:
+    explicit clonable_str(std::tuple<std::string> s):
+        clonable_str(std::get<0>(s)) {}
+    explicit clonable_str(const char* s): clonable_str(std::string{s}) {}
+    explicit clonable_str(std::string s = {}):
+        clonable(std::tuple<>{}), s(std::move(s)) {}
+    std::string s;
+};
+
+inline std::ostream& operator<<(std::ostream& os, const clonable_str& v)
+{
+    return os << v.s;
+}
+
+class clonable_int_str:
+    public clonable<clonable_int_str, clonable_int, clonable_str>
+{
+public:
+    explicit clonable_int_str(int i = {}, std::string s = {}):
+        clonable(std::tuple{i}, std::tuple{std::move(s)}) {}
+};
+
+inline std::ostream& operator<<(std::ostream& os, const clonable_int_str& v)
+{
+    operator<<(os, static_cast<const clonable_int&>(v));
+    os << ',';
+    operator<<(os, static_cast<const clonable_str&>(v));
+    return os;
+}
+
+class clonable_int1: public clonable<clonable_int1, clonable_int> {
+    using clonable<clonable_int1, clonable_int>::clonable;
+};
+
+class clonable_int2: public clonable<clonable_int2, clonable_int> {
+    using clonable<clonable_int2, clonable_int>::clonable;
+};
+
+class clonable_int12:
+    public clonable<clonable_int12, clonable_int1, clonable_int2>
+{
+public:
+    explicit clonable_int12(int i1 = {}, int i2 = {}):
+        clonable(std::tuple{i1}, std::tuple{i2}) {}
+};
+
+inline std::ostream& operator<<(std::ostream& os, const clonable_int12& v)
+{
+    operator<<(os, static_cast<const clonable_int1&>(v));
+    os << ',';
+    operator<<(os, static_cast<const clonable_int2&>(v));
+    return os;
+}
+
+// A monotonic arena usable by clonable::clone_in(). Memory is allocated in
+// blocks and released at once, together with destroying all objects, when the
+// arena is destroyed.
+class clone_arena {
+public:
+    explicit clone_arena(size_t block_size = 64 * 1024):
+        block_size(block_size) {}
+    clone_arena(const clone_arena&) = delete;
+    clone_arena& operator=(const clone_arena&) = delete;
+    ~clone_arena() {
+        for (auto it = objects.rbegin(); it != objects.rend(); ++it)
+            it->destroy(it->p);
+        for (auto& b: blocks)
+            ::operator delete(b.p, std::align_val_t{b.align});
+    }
+    // Makes the next allocations of up to size bytes (including alignment),
+    // starting at alignment align, use a single block, and prepares for
+    // registering count objects by destroy_later()
+    void reserve(size_t size, size_t align = alignof(std::max_align_t),
+                 size_t count = 0)
+    {
+        align = std::max(align, alignof(std::max_align_t));
+        if (free_size() < size + align - 1)
+            add_block(size, align);
+        objects.reserve(objects.size() + count);
+    }
+    void* allocate(size_t size, size_t align) {
+        if (void* p = std::align(align, size, next, free))
+            return bump(p, size);
+        add_block(std::max(size, block_size),
+                  std::max(align, alignof(std::max_align_t)));
+        return bump(next, size);
+    }
+    // Constructs an object in the arena, destroyed together with the arena
+    template <class T, class ...A> T* emplace(A&& ...a) {
+        T* p = ::new (allocate(sizeof(T), alignof(T)))
+            T(std::forward<A>(a)...);
+        destroy_later(p);
+        return p;
+    }
+    template <class T> void destroy_later(T* p) {
+        if constexpr (!std::is_trivially_destructible_v<T>) {
+            try {
+                objects.push_back({p, [](void* o) {
+                    static_cast<T*>(o)->~T();
+                }});
+            } catch (...) {
+                p->~T();
+                throw;
+            }
+        }
+    }
+    // Number of allocated blocks
+    size_t allocations() const noexcept {
+        return blocks.size();
+    }
+private:
+    struct block {
+        void* p;
+        size_t align;
+    };
+    struct object {
+        void* p;
+        void (*destroy)(void*);
+    };
+    size_t free_size() const noexcept {
+        return blocks.empty() ? 0 : free;
+    }
+    void add_block(size_t size, size_t align) {
+        blocks.reserve(blocks.size() + 1);
+        next = ::operator new(size, std::align_val_t{align});
+        free = size;
+        blocks.push_back({next, align});
+    }
+    void* bump(void* p, size_t size) noexcept {
+        next = static_cast<char*>(p) + size;
+        free -= size;
+        return p;
+    }
+    size_t block_size;
+    std::vector<block> blocks;
+    std::vector<object> objects;
+    void* next = nullptr;
+    size_t free = 0;
+};
+
+// Clones objects pointed to by elements (pointers or smart pointers) of range
+// r into arena. The total size of all copies is computed first, so that the
+// arena allocates a single block for all of them.
+template <class R> auto bulk_clone(const R& r, clone_arena& arena)
+{
+    using B = std::remove_cv_t<
+        std::remove_reference_t<decltype(**std::begin(r))>>;
+    size_t size = 0;
+    size_t align = 1;
+    size_t n = 0;
+    for (auto& p: r) {
+        auto l = p->clone_layout();
+        size = (size + l.align - 1) / l.align * l.align + l.size;
+        align = std::max(align, l.align);
+        ++n;
+    }
+    std::vector<B*> copies;
+    copies.reserve(n);
+    arena.reserve(size, align, n);
+    for (auto& p: r)
+        copies.push_back(p->clone_in(arena));
+    return copies;
+}
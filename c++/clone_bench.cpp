@@ -0,0 +1,68 @@
+/* Throughput of cloning objects of the clonable hierarchy from
+ * class_clone.hpp by clone() returning std::shared_ptr, by clone_unique()
+ * returning std::unique_ptr, and by clone_in() into an arena
+ *
+ * Usage: clone_bench [clones]
+ *
+ * Compile with C++17 or higher
+ */
+
+#include "bench.hpp"
+#include "class_clone.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <string_view>
+
+void display(std::string_view type, std::string_view method, double ns)
+{
+    std::cout << std::setw(16) << type << std::setw(14) << method <<
+        std::fixed << std::setprecision(2) << " Mclones/s=" << 1e3 / ns <<
+        " ns/clone=" << ns << std::defaultfloat << std::endl;
+}
+
+// Cloned via a reference to base class B
+template <class B, class T> void run(std::string_view type, T&& v, size_t n)
+{
+    B& o = v;
+    auto c = std::string(type) + ' ';
+    display(type, "clone", bench::ns_per_op(c + "clone", n, [&o](size_t) {
+        auto p = o.clone();
+        bench::do_not_optimize(p);
+    }));
+    display(type, "clone_unique",
+            bench::ns_per_op(c + "clone_unique", n, [&o](size_t) {
+        auto p = o.clone_unique();
+        bench::do_not_optimize(p);
+    }));
+    // Copies are released in batches, so that they stay in cache similarly
+    // to the copies released immediately by the other methods
+    constexpr size_t batch = 1000;
+    size_t batches = std::max<size_t>(n / batch, 1);
+    display(type, "clone_in",
+            bench::ns_per_op(c + "clone_in", batches, [&o](size_t) {
+        clone_arena arena;
+        for (size_t i = 0; i < batch; ++i) {
+            auto p = o.clone_in(arena);
+            bench::do_not_optimize(p);
+        }
+    }) / batch);
+}
+
+#define RUN(base, ...) run<base>(#base, __VA_ARGS__, n)
+
+int main(int argc, char* argv[])
+{
+    size_t n = 1'000'000;
+    if (argc > 1)
+        n = std::stoull(argv[1]);
+    RUN(clonable_int, clonable_int(1));
+    RUN(clonable_str, clonable_str("a"));
+    RUN(clonable_int_str, clonable_int_str(2, "b"));
+    RUN(clonable_int12, clonable_int12(3, 4));
+    RUN(clonable_int2, clonable_int12(5, 6));
+    return EXIT_SUCCESS;
+}
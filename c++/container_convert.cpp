@@ -0,0 +1,115 @@
+/* container_convert_f from container_convert.hpp compared to the original
+ * element by element version from template_lambda.cpp
+ *
+ * Usage: container_convert [elements [repeat]]
+ *
+ * Compile with C++20 or higher
+ */
+
+#include "bench.hpp"
+#include "container_convert.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <list>
+#include <random>
+#include <set>
+#include <string>
+#include <string_view>
+#include <vector>
+
+template <template <class ...> class T, class C>
+auto container_convert_naive(C&& c)
+{
+    using r_type = T<typename std::decay_t<C>::value_type>;
+    r_type r;
+    for (auto&&v: c)
+        if constexpr (requires () { r.push_back(v); })
+            r.push_back(v);
+        else if constexpr (requires() { r.insert(v); })
+            r.insert(v);
+        else
+            static_assert(false && sizeof(C) > 1);
+    return r;
+}
+
+void display(std::string_view conversion, std::string_view method, size_t n,
+             double ns)
+{
+    std::cout << std::setw(36) << conversion << std::setw(7) << method <<
+        std::fixed << std::setprecision(2) << " ns/element=" << ns / n <<
+        std::defaultfloat << std::endl;
+}
+
+template <template <class ...> class T, class C>
+void run(std::string_view name, const C& src, size_t repeat)
+{
+    auto c = std::string(name) + ' ';
+    display(name, "naive", src.size(),
+            bench::ns_per_op(c + "naive", repeat, [&src](size_t) {
+        auto r = container_convert_naive<T>(src);
+        bench::do_not_optimize(r);
+    }));
+    display(name, "fast", src.size(),
+            bench::ns_per_op(c + "fast", repeat, [&src](size_t) {
+        auto r = container_convert_f<T>(src);
+        bench::do_not_optimize(r);
+    }));
+}
+
+// Converting an rvalue, the time of copying the source is excluded
+template <template <class ...> class T, class C>
+void run_rvalue(std::string_view name, const C& src, size_t repeat)
+{
+    double ns[2] = {};
+    for (size_t i = 0; i < repeat; ++i) {
+        C c1 = src;
+        C c2 = src;
+        auto start = bench::clock::now();
+        auto r1 = container_convert_naive<T>(std::move(c1));
+        ns[0] += bench::ns_since(start);
+        bench::do_not_optimize(r1);
+        start = bench::clock::now();
+        auto r2 = container_convert_f<T>(std::move(c2));
+        ns[1] += bench::ns_since(start);
+        bench::do_not_optimize(r2);
+    }
+    display(name, "naive", src.size(), ns[0] / repeat);
+    display(name, "fast", src.size(), ns[1] / repeat);
+}
+
+int main(int argc, char* argv[])
+{
+    size_t n = 1'000'000;
+    size_t repeat = 5;
+    if (argc > 1)
+        n = std::stoull(argv[1]);
+    if (argc > 2)
+        repeat = std::stoull(argv[2]);
+    std::vector<int> sorted(n);
+    for (size_t i = 0; i < n; ++i)
+        sorted[i] = int(i);
+    std::vector<int> shuffled = sorted;
+    std::shuffle(shuffled.begin(), shuffled.end(), std::mt19937(1));
+    std::list<int> sorted_list(sorted.begin(), sorted.end());
+    std::list<int> shuffled_list(shuffled.begin(), shuffled.end());
+    run<std::vector>("list<int> -> vector", sorted_list, repeat);
+    run<std::vector>("vector<int> -> vector", sorted, repeat);
+    std::vector<std::string> strings(n);
+    for (size_t i = 0; i < n; ++i)
+        strings[i] = std::string(24, 'a') + std::to_string(i);
+    run_rvalue<std::vector>("rvalue vector<string> -> vector", strings,
+                            repeat);
+    // sets built from shuffled input leave the heap fragmented, which slows
+    // down later allocations, hence they go last
+    run<std::set>("sorted list<int> -> set", sorted_list, repeat);
+    run<std::set>("sorted vector<int> -> set", sorted, repeat);
+    std::sort(strings.begin(), strings.end());
+    run_rvalue<std::set>("rvalue sorted vector<string> -> set", strings,
+                         repeat);
+    run<std::set>("shuffled list<int> -> set", shuffled_list, repeat);
+    run<std::set>("shuffled vector<int> -> set", shuffled, repeat);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+/* Conversion of a container to a container template instantiated with the
+ * same value type, e.g., std::list<int> to std::vector<int> or std::set<int>
+ *
+ * The conversion uses the best operations the target supports: reserve(),
+ * range insert, and, for an ordered target and an input already sorted by
+ * its comparison, insertion with the hint end(), which takes constant time.
+ * Elements of an rvalue input are moved.
+ *
+ * Compile with C++20 or higher
+ */
+
+#include <algorithm>
+#include <iterator>
+#include <ranges>
+#include <type_traits>
+#include <utility>
+
+// Fills r with [first, last), which are the elements of c, possibly accessed
+// via move iterators
+template <class R, class C, class I>
+void container_convert_fill(R& r, const C& c, I first, I last)
+{
+    if constexpr (requires { r.reserve(std::ranges::size(c)); })
+        r.reserve(std::ranges::size(c));
+    if constexpr (requires { r.key_comp(); r.emplace_hint(r.end(), *first); })
+    {
+        if (std::is_sorted(std::ranges::begin(c), std::ranges::end(c),
+                           r.key_comp()))
+        {
+            for (; first != last; ++first)
+                r.emplace_hint(r.end(), *first);
+            return;
+        }
+    }
+    if constexpr (requires { r.insert(r.end(), first, last); })
+        r.insert(r.end(), first, last);
+    else if constexpr (requires { r.insert(first, last); })
+        r.insert(first, last);
+    else
+        for (; first != last; ++first)
+            if constexpr (requires () { r.push_back(*first); })
+                r.push_back(*first);
+            else if constexpr (requires() { r.insert(*first); })
+                r.insert(*first);
+            else {
+                //static_assert(false); // does not work in g++-12, clang++-15
+                static_assert(false && sizeof(C) > 1); // false dependent on C
+            }
+}
+
+template <template <class ...> class T, class C>
+auto container_convert_f(C&& c)
+{
+    using r_type = T<typename std::decay_t<C>::value_type>;
+    r_type r;
+    if constexpr (std::is_rvalue_reference_v<C&&>)
+        container_convert_fill(r, c,
+                               std::make_move_iterator(std::ranges::begin(c)),
+                               std::make_move_iterator(std::ranges::end(c)));
+    else
+        container_convert_fill(r, c, std::ranges::begin(c),
+                               std::ranges::end(c));
+    return r;
+}
+
+template <template <class ...> class T> constexpr auto container_convert_l =
+    []<class C>(C&& c) {
+        return container_convert_f<T>(std::forward<C>(c));
+    };
+
+template <class T> auto convert(auto&& converter, T&& c)
+{
+    return converter(std::forward<T>(c));
+}
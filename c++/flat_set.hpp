@@ -0,0 +1,97 @@
+#pragma once
+
+/* A set stored as a sorted std::vector
+ *
+ * Lookup is a binary search in contiguous memory, insertion of a single
+ * element takes linear time. Intended for sets built once and searched
+ * often, preferably from a range already sorted and without duplicates.
+ *
+ * Compile with C++17 or higher
+ */
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <utility>
+#include <vector>
+
+// Tag for constructing from a range sorted without duplicates
+struct sorted_unique_t {
+    explicit sorted_unique_t() = default;
+};
+inline constexpr sorted_unique_t sorted_unique{};
+
+template <class T, class Compare = std::less<T>> class flat_set {
+public:
+    using value_type = T;
+    using key_type = T;
+    using key_compare = Compare;
+    using size_type = size_t;
+    using const_iterator = typename std::vector<T>::const_iterator;
+    using iterator = const_iterator;
+    flat_set() = default;
+    explicit flat_set(const Compare& comp): comp(comp) {}
+    template <class I>
+    flat_set(I first, I last, const Compare& comp = Compare()): comp(comp) {
+        insert(first, last);
+    }
+    // v must be sorted by comp and without duplicates
+    flat_set(sorted_unique_t, std::vector<T> v,
+             const Compare& comp = Compare()):
+        v(std::move(v)), comp(comp) {}
+    const_iterator begin() const noexcept {
+        return v.begin();
+    }
+    const_iterator end() const noexcept {
+        return v.end();
+    }
+    size_type size() const noexcept {
+        return v.size();
+    }
+    bool empty() const noexcept {
+        return v.empty();
+    }
+    void reserve(size_type n) {
+        v.reserve(n);
+    }
+    key_compare key_comp() const {
+        return comp;
+    }
+    const_iterator lower_bound(const T& k) const {
+        return std::lower_bound(v.begin(), v.end(), k, comp);
+    }
+    const_iterator find(const T& k) const {
+        auto i = lower_bound(k);
+        return i != v.end() && !comp(k, *i) ? i : v.end();
+    }
+    bool contains(const T& k) const {
+        return find(k) != v.end();
+    }
+    std::pair<iterator, bool> insert(T k) {
+        auto i = lower_bound(k);
+        if (i != v.end() && !comp(k, *i))
+            return {i, false};
+        return {v.insert(i, std::move(k)), true};
+    }
+    // Appends the range, then sorts and removes duplicates
+    template <class I> void insert(I first, I last) {
+        auto n = v.size();
+        v.insert(v.end(), first, last);
+        auto mid = v.begin() + n;
+        std::sort(mid, v.end(), comp);
+        std::inplace_merge(v.begin(), mid, v.end(), comp);
+        v.erase(std::unique(v.begin(), v.end(), [this](auto& a, auto& b) {
+            return !comp(a, b);
+        }), v.end());
+    }
+    void clear() noexcept {
+        v.clear();
+    }
+    // Moves the elements out, leaving the set empty
+    std::vector<T> extract() && {
+        return std::move(v);
+    }
+private:
+    std::vector<T> v;
+    Compare comp;
+};
@@ -0,0 +1,93 @@
+/* Writing records as text by format_sink compared to std::ofstream
+ *
+ * Usage: format_sink [records [file]]
+ *   The default file is /dev/null.
+ *
+ * Compile with C++17 or higher on a POSIX system
+ */
+
+#include "bench.hpp"
+#include "format_sink.hpp"
+#include "tuple_for.hpp"
+
+#include <cerrno>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <tuple>
+#include <vector>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+using record = std::tuple<long, double, std::string, int, bool, const char*,
+                          char, float>;
+
+record make_record(size_t i)
+{
+    return {long(i) * 7919, double(i) / 7, std::string(8 + i % 24, 'x'),
+            int(i % 1000), i % 2 == 0, "label", char('a' + i % 26),
+            float(i) * 0.5f};
+}
+
+// Writes a record as a line of comma separated values
+template <class S> struct csv {
+    template <class T> void operator()(const T& v) {
+        os << d << v;
+        d = ",";
+    }
+    S& os;
+    std::string_view d = "";
+};
+
+template <class S> void write_records(S& os, const std::vector<record>& v)
+{
+    for (auto& r: v) {
+        tuple_for(csv<S>{os}, r);
+        os << '\n';
+    }
+}
+
+void display(std::string_view method, size_t n, double ns)
+{
+    std::cout << std::setw(12) << method << std::fixed << std::setprecision(2) <<
+        " Mrecords/s=" << 1e3 * n / ns << std::defaultfloat << std::endl;
+}
+
+int main(int argc, char* argv[])
+{
+    size_t n = 1'000'000;
+    std::string path = "/dev/null";
+    if (argc > 1)
+        n = std::stoull(argv[1]);
+    if (argc > 2)
+        path = argv[2];
+    std::vector<record> records;
+    records.reserve(n);
+    for (size_t i = 0; i < n; ++i)
+        records.push_back(make_record(i));
+    {
+        auto start = bench::clock::now();
+        std::ofstream os(path);
+        write_records(os, records);
+        os.close();
+        display("ofstream", n, bench::ns_since(start));
+    }
+    {
+        auto start = bench::clock::now();
+        int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0666);
+        if (fd < 0)
+            throw std::system_error(errno, std::generic_category(), path);
+        {
+            format_sink os(fd);
+            write_records(os, records);
+        }
+        ::close(fd);
+        display("format_sink", n, bench::ns_since(start));
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,130 @@
+#pragma once
+
+/* A buffered text output to a file descriptor, a fast replacement of
+ * std::ostream for dumping large amounts of data
+ *
+ * Integers and floating point numbers are formatted by std::to_chars
+ * directly into the buffer, independently of the locale. Floating point
+ * numbers use the shortest representation that reads back to the same value.
+ * Strings are copied into the buffer or, if they are longer than the buffer,
+ * written directly from their memory. The buffer is written by write(2) when
+ * full, by flush(), and by the destructor.
+ *
+ * Compile with C++17 or higher on a POSIX system
+ */
+
+#include <cerrno>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+
+#include <unistd.h>
+
+class format_sink {
+    template <class T> static constexpr bool is_number =
+        std::is_arithmetic_v<T> && !std::is_same_v<T, bool> &&
+        !std::is_same_v<T, char> && !std::is_same_v<T, signed char> &&
+        !std::is_same_v<T, unsigned char>;
+    // Enough for any number formatted by std::to_chars
+    static constexpr size_t min_free = 128;
+public:
+    explicit format_sink(int fd = STDOUT_FILENO, size_t block_size = 1 << 16):
+        fd(fd), cap(block_size < min_free ? min_free : block_size),
+        buf(new char[cap])
+    {
+    }
+    format_sink(const format_sink&) = delete;
+    format_sink& operator=(const format_sink&) = delete;
+    // Errors of writing the rest of the buffer are ignored, call flush() to
+    // detect them
+    ~format_sink() {
+        try {
+            flush();
+        } catch (...) {
+        }
+    }
+    // Throws std::system_error on failure
+    void flush() {
+        write_all(buf.get(), len);
+        len = 0;
+    }
+    format_sink& operator<<(std::string_view s) {
+        if (s.size() <= cap - len) {
+            std::memcpy(buf.get() + len, s.data(), s.size());
+            len += s.size();
+        } else if (s.size() < cap) {
+            flush();
+            std::memcpy(buf.get(), s.data(), s.size());
+            len = s.size();
+        } else {
+            flush();
+            write_all(s.data(), s.size());
+        }
+        return *this;
+    }
+    format_sink& operator<<(const char* s) {
+        return *this << std::string_view(s);
+    }
+    format_sink& operator<<(char c) {
+        if (len == cap)
+            flush();
+        buf[len++] = c;
+        return *this;
+    }
+    // Like std::ostream, writes signed and unsigned char as characters
+    format_sink& operator<<(signed char c) {
+        return *this << char(c);
+    }
+    format_sink& operator<<(unsigned char c) {
+        return *this << char(c);
+    }
+    // Like std::ostream, writes "1" or "0", or "true" or "false" if
+    // boolalpha is set
+    format_sink& operator<<(bool b) {
+        if (boolalpha)
+            return *this << (b ? "true" : "false");
+        return *this << (b ? '1' : '0');
+    }
+    template <class T>
+    auto operator<<(T v) -> std::enable_if_t<is_number<T>, format_sink&> {
+        if (cap - len < min_free)
+            flush();
+        auto r = std::to_chars(buf.get() + len, buf.get() + cap, v);
+        len = r.ptr - buf.get();
+        return *this;
+    }
+    format_sink& operator<<(const void* p) {
+        if (cap - len < min_free)
+            flush();
+        buf[len++] = '0';
+        buf[len++] = 'x';
+        auto r = std::to_chars(buf.get() + len, buf.get() + cap,
+                               reinterpret_cast<std::uintptr_t>(p), 16);
+        len = r.ptr - buf.get();
+        return *this;
+    }
+    bool boolalpha = false;
+private:
+    void write_all(const char* p, size_t n) {
+        while (n > 0) {
+            ssize_t r = ::write(fd, p, n);
+            if (r < 0) {
+                if (errno == EINTR)
+                    continue;
+                throw std::system_error(errno, std::generic_category(),
+                                        "format_sink: write failed");
+            }
+            p += r;
+            n -= r;
+        }
+    }
+    int fd;
+    size_t cap;
+    std::unique_ptr<char[]> buf;
+    size_t len = 0;
+};
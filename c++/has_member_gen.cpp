@@ -0,0 +1,159 @@
+/* Compile time and peak memory of the compiler for the idioms of testing if
+ * a class has a member from has_member.cpp
+ *
+ * For each idiom, generates a translation unit with many classes and
+ * members, which tests every member of every class by the idiom in
+ * a static_assert, and compiles it by each of the compilers. The idioms are:
+ *   void_t   a void_t specialization written for each member
+ *   macro    the same specialization generated by DEF_HAS_MEMBER
+ *   concept  a variable initialized by a requires expression for each member
+ *   lambda   the HAS_MEMBER macro with a requires expression in a lambda
+ *
+ * Usage: has_member_gen [classes [members [compiler...]]]
+ *   The defaults are 2000 classes, 8 members, and compilers g++ and clang++.
+ *   The generated files are kept in the temporary directory.
+ *
+ * Compile with C++17 or higher on a POSIX system
+ */
+
+#include "bench.hpp"
+
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <sys/resource.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+// Class c has member m if this is true
+bool has(size_t c, size_t m)
+{
+    return (c + m) % 3 != 0;
+}
+
+void generate(std::ostream& os, std::string_view idiom, size_t classes,
+              size_t members)
+{
+    os << "#include <type_traits>\n\n";
+    for (size_t c = 0; c < classes; ++c) {
+        os << "struct c" << c << " {\n";
+        for (size_t m = 0; m < members; ++m)
+            if (has(c, m))
+                os << "    int m" << m << ";\n";
+        os << "};\n";
+    }
+    os << '\n';
+    if (idiom == "macro")
+        os << "#define DEF_HAS_MEMBER(m) \\\n"
+            "    template <class, class = void> \\\n"
+            "    struct has_##m: std::false_type {}; \\\n"
+            "    template <class T> \\\n"
+            "    struct has_##m<T, std::void_t<decltype(&T::m)>>: \\\n"
+            "        std::true_type {};\n\n";
+    if (idiom == "lambda")
+        os << "#define HAS_MEMBER(t, m) \\\n"
+            "    [](auto v) { \\\n"
+            "        return requires { &decltype(v)::type::m; }; \\\n"
+            "    }(std::type_identity<t>{})\n\n";
+    for (size_t m = 0; m < members; ++m) {
+        if (idiom == "void_t")
+            os << "template <class, class = void> struct has_m" << m <<
+                ": std::false_type {};\n"
+                "template <class T> struct has_m" << m <<
+                "<T, std::void_t<decltype(&T::m" << m << ")>>:\n"
+                "    std::true_type {};\n";
+        else if (idiom == "macro")
+            os << "DEF_HAS_MEMBER(m" << m << ")\n";
+        else if (idiom == "concept")
+            os << "template <class T> inline constexpr bool has_m" << m <<
+                " = requires { &T::m" << m << "; };\n";
+    }
+    os << '\n';
+    for (size_t c = 0; c < classes; ++c)
+        for (size_t m = 0; m < members; ++m) {
+            os << "static_assert(" << (has(c, m) ? "" : "!");
+            if (idiom == "concept")
+                os << "has_m" << m << "<c" << c << ">";
+            else if (idiom == "lambda")
+                os << "HAS_MEMBER(c" << c << ", m" << m << ")";
+            else
+                os << "has_m" << m << "<c" << c << ">::value";
+            os << ");\n";
+        }
+}
+
+struct result {
+    int status; // the exit status, 127 if the command was not found
+    double seconds;
+    long peak_kb;
+};
+
+// Runs the command and measures its time and peak resident memory
+result run(const std::vector<std::string>& cmd)
+{
+    std::vector<char*> argv;
+    for (auto& a: cmd)
+        argv.push_back(const_cast<char*>(a.c_str()));
+    argv.push_back(nullptr);
+    auto start = bench::clock::now();
+    pid_t pid = fork();
+    if (pid < 0)
+        return {-1, 0, 0};
+    if (pid == 0) {
+        execvp(argv[0], argv.data());
+        _exit(127);
+    }
+    int status;
+    rusage usage;
+    // On Linux, ru_maxrss includes the descendants waited for by the child,
+    // hence the compiler proper run by the compiler driver
+    if (wait4(pid, &status, 0, &usage) < 0)
+        return {-1, 0, 0};
+    double seconds = bench::ns_since(start) / 1e9;
+    return {WIFEXITED(status) ? WEXITSTATUS(status) : -1, seconds,
+            usage.ru_maxrss};
+}
+
+int main(int argc, char* argv[])
+{
+    size_t classes = 2000;
+    size_t members = 8;
+    std::vector<std::string> compilers{"g++", "clang++"};
+    if (argc > 1)
+        classes = std::stoull(argv[1]);
+    if (argc > 2)
+        members = std::stoull(argv[2]);
+    if (argc > 3)
+        compilers.assign(argv + 3, argv + argc);
+    auto dir = std::filesystem::temp_directory_path();
+    for (std::string_view idiom: {"void_t", "macro", "concept", "lambda"}) {
+        auto path = dir / ("has_member_" + std::string(idiom) + ".cpp");
+        {
+            std::ofstream os(path);
+            generate(os, idiom, classes, members);
+        }
+        for (auto& cxx: compilers) {
+            auto r = run({cxx, "-std=c++20", "-c", "-o", "/dev/null",
+                          path.string()});
+            std::cout << std::setw(8) << cxx << " idiom=" << std::setw(7) <<
+                idiom << " checks=" << classes * members;
+            if (r.status == 0)
+                std::cout << std::fixed << std::setprecision(2) <<
+                    " seconds=" << r.seconds << std::defaultfloat <<
+                    " peak_MB=" << r.peak_kb / 1024;
+            else if (r.status == 127)
+                std::cout << " not found";
+            else
+                std::cout << " failed";
+            std::cout << std::endl;
+        }
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,106 @@
+/* Single pass over the result of convert() with lazy_convert_l from
+ * lazy_convert.hpp compared to container_convert_l from container_convert.hpp
+ *
+ * Usage: lazy_convert [elements [repeat]]
+ *
+ * Compile with C++20 or higher, together with new_delete.cpp
+ */
+
+#include "bench.hpp"
+#include "container_convert.hpp"
+#include "lazy_convert.hpp"
+#include "new_delete.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <list>
+#include <random>
+#include <ranges>
+#include <set>
+#include <string>
+#include <string_view>
+#include <vector>
+
+void display(std::string_view conversion, std::string_view method, size_t n,
+             size_t repeat, double ns, size_t bytes, long sum)
+{
+    std::cout << std::setw(34) << conversion << std::setw(6) << method <<
+        std::fixed << std::setprecision(2) << " ns/element=" << ns / n <<
+        std::defaultfloat << " bytes/element=" << double(bytes) / repeat / n <<
+        " sum=" << sum << std::endl;
+}
+
+// f() converts and consumes the result, returning a sum
+template <class F>
+void run(std::string_view name, std::string_view method, size_t n,
+         size_t repeat, F f)
+{
+    long sum = 0;
+    size_t bytes = new_delete::new_bytes;
+    double ns = bench::ns_per_op(std::string(name) + ' ' + std::string(method),
+                                 repeat, [&f, &sum](size_t) {
+        sum = f();
+        bench::do_not_optimize(sum);
+    });
+    display(name, method, n, repeat, ns, new_delete::new_bytes - bytes, sum);
+}
+
+template <template <class ...> class T, class C>
+void run_both(std::string_view name, const C& c, size_t repeat)
+{
+    auto sum = [](auto&& r) {
+        long s = 0;
+        for (auto v: r)
+            s += v;
+        return s;
+    };
+    run(name, "eager", c.size(), repeat, [&c, &sum] {
+        return sum(convert(container_convert_l<T>, c));
+    });
+    run(name, "lazy", c.size(), repeat, [&c, &sum] {
+        return sum(convert(lazy_convert_l<T>, c));
+    });
+}
+
+int main(int argc, char* argv[])
+{
+    size_t n = 1'000'000;
+    size_t repeat = 10;
+    if (argc > 1)
+        n = std::stoull(argv[1]);
+    if (argc > 2)
+        repeat = std::stoull(argv[2]);
+    // every value twice
+    std::vector<int> sorted(n);
+    for (size_t i = 0; i < n; ++i)
+        sorted[i] = int(i / 2);
+    std::vector<int> shuffled = sorted;
+    std::shuffle(shuffled.begin(), shuffled.end(), std::mt19937(1));
+    std::list<int> list(shuffled.begin(), shuffled.end());
+    run_both<std::vector>("list -> vector", list, repeat);
+    run_both<std::vector>("vector -> vector", shuffled, repeat);
+    run_both<std::set>("sorted vector -> set", sorted, repeat);
+    run_both<std::set>("shuffled vector -> set", shuffled, repeat);
+    auto pipeline = std::views::filter([](int v) { return v % 3 == 0; }) |
+        std::views::transform([](int v) { return v * 2; });
+    run("list -> vector | filter | transform", "eager", n, repeat,
+        [&list, &pipeline] {
+            long s = 0;
+            for (auto v: convert(container_convert_l<std::vector>, list) |
+                     pipeline)
+            {
+                s += v;
+            }
+            return s;
+        });
+    run("list -> vector | filter | transform", "lazy", n, repeat,
+        [&list, &pipeline] {
+            long s = 0;
+            for (auto v: convert(lazy_convert_l<std::vector>, list) | pipeline)
+                s += v;
+            return s;
+        });
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,142 @@
+#pragma once
+
+/* A lazy counterpart of container_convert_l from container_convert.hpp
+ *
+ * convert(lazy_convert_l<T>, c) returns a view of c with the semantics of
+ * container T instead of a new container:
+ * - for a sequence container target, e.g., std::vector, the view passes the
+ *   elements of c through unchanged
+ * - for an ordered set target, e.g., std::set, the view yields the elements
+ *   in the order of the set's comparison, without duplicates. If c is
+ *   already sorted, which is checked on the first call of begin(), the
+ *   duplicates are skipped during iteration without any allocation.
+ *   Otherwise, the elements are copied, sorted, and deduplicated on the first
+ *   call of begin(). Copies of the view made afterwards share the copied
+ *   elements, so that copying the view takes constant time.
+ *
+ * The views compose with std::ranges pipelines. An rvalue c is moved into
+ * the view.
+ *
+ * Compile with C++20 or higher
+ */
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <ranges>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+template <std::ranges::forward_range V, class Compare>
+requires std::ranges::view<V> && std::ranges::common_range<V>
+class set_view: public std::ranges::view_interface<set_view<V, Compare>> {
+public:
+    using value_type = std::ranges::range_value_t<V>;
+    class iterator {
+    public:
+        using iterator_concept = std::forward_iterator_tag;
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = set_view::value_type;
+        using difference_type = std::ptrdiff_t;
+        using reference = std::common_reference_t<
+            std::ranges::range_reference_t<V>, const value_type&>;
+        iterator() = default;
+        reference operator*() const {
+            if (p)
+                return *p;
+            return *cur;
+        }
+        iterator& operator++() {
+            if (p)
+                ++p;
+            else {
+                auto prev = cur;
+                while (++cur != last && !(*comp)(*prev, *cur))
+                    ;
+            }
+            return *this;
+        }
+        iterator operator++(int) {
+            auto i = *this;
+            ++*this;
+            return i;
+        }
+        bool operator==(const iterator& o) const {
+            return p == o.p && cur == o.cur;
+        }
+    private:
+        friend set_view;
+        // Iterates [cur, last) skipping duplicates, or the copy if p is set
+        std::ranges::iterator_t<V> cur{};
+        std::ranges::iterator_t<V> last{};
+        const value_type* p = nullptr;
+        const Compare* comp = nullptr;
+    };
+    set_view() = default;
+    explicit set_view(V base, Compare comp = Compare()):
+        base(std::move(base)), comp(std::move(comp)) {}
+    iterator begin() {
+        prepare();
+        iterator i;
+        if (copy) {
+            i.p = copy->data();
+        } else {
+            i.cur = std::ranges::begin(base);
+            i.last = std::ranges::end(base);
+            i.comp = &comp;
+        }
+        return i;
+    }
+    iterator end() {
+        prepare();
+        iterator i;
+        if (copy)
+            i.p = copy->data() + copy->size();
+        else
+            i.cur = i.last = std::ranges::end(base);
+        return i;
+    }
+    // Whether the elements have been copied because they were not sorted
+    bool materialized() const noexcept {
+        return copy != nullptr;
+    }
+private:
+    void prepare() {
+        if (sorted || copy)
+            return;
+        if (std::ranges::is_sorted(base, comp))
+            sorted = true;
+        else {
+            auto v = std::make_shared<std::vector<value_type>>(
+                std::ranges::begin(base), std::ranges::end(base));
+            std::ranges::sort(*v, comp);
+            auto equal = [this](const auto& a, const auto& b) {
+                return !comp(a, b);
+            };
+            v->erase(std::unique(v->begin(), v->end(), equal), v->end());
+            copy = std::move(v);
+        }
+    }
+    V base{};
+    Compare comp{};
+    bool sorted = false;
+    std::shared_ptr<const std::vector<value_type>> copy;
+};
+
+template <template <class ...> class T> constexpr auto lazy_convert_l =
+    []<class C>(C&& c) {
+        using r_type = T<std::ranges::range_value_t<C>>;
+        auto all = std::views::all(std::forward<C>(c));
+        if constexpr (requires { typename r_type::key_compare; }) {
+            auto common = std::views::common(std::move(all));
+            return set_view<decltype(common), typename r_type::key_compare>(
+                std::move(common));
+        } else if constexpr (requires (r_type r) {
+            r.push_back(*std::ranges::begin(c));
+        })
+            return all;
+        else
+            static_assert(false && sizeof(C) > 1, "unsupported target");
+    };
@@ -1,11 +1,16 @@
 /* Effects of different memory order
  * On x86_64, this program should be compiled with -fsanitize=thread. When run
  * with argument "relaxed", the thread sanitizer reports a data race. It runs
- * without a data race with other memory orders.
+ * without a data race with other memory orders. With argument iterations,
+ * it stops after that many values passed and reports the time and hardware
+ * counters per value from perf_counters.hpp.
  *
  * Compile with C++17 or higher
  */
 
+#include "perf_counters.hpp"
+
+#include <array>
 #include <atomic>
 #include <cstdlib>
 #include <iostream>
@@ -15,8 +20,8 @@
 
 int usage(std::string_view argv0)
 {
-    std::cerr << "usage: " << argv0 << " {relaxed|acq_rel|seq_cst}" <<
-        std::endl;
+    std::cerr << "usage: " << argv0 <<
+        " {relaxed|acq_rel|seq_cst} [iterations]" << std::endl;
     return EXIT_FAILURE;
 }
 
@@ -45,10 +50,11 @@ using data_t = std::array<unsigned long long, sz>;
 data_t data{};
 std::atomic<unsigned long long> cnt{0};
 
-void f_prod(std::memory_order mo)
+// Runs forever if n == 0
+void f_prod(std::memory_order mo, size_t n)
 {
     auto [mr, mw] = mo_rw(mo);
-    for (size_t i = 1;; ++i) {
+    for (size_t i = 1; n == 0 || i <= n; ++i) {
         data[i % sz] = i;
         cnt.store(i, mw);
         while (cnt.load(mr) != 0)
@@ -56,11 +62,11 @@ void f_prod(std::memory_order mo)
     }
 }
 
-void f_cons(std::memory_order mo)
+void f_cons(std::memory_order mo, size_t n)
 {
     auto [mr, mw] = mo_rw(mo);
     unsigned long long failures = 0;
-    for (size_t i = 1;; ++i) {
+    for (size_t i = 1; n == 0 || i <= n; ++i) {
         decltype(cnt)::value_type c;
         do {
             c = cnt.load(mr);
@@ -78,7 +84,7 @@ void f_cons(std::memory_order mo)
 
 int main(int argc, char* argv[])
 {
-    if (argc != 2)
+    if (argc != 2 && argc != 3)
         return usage(argv[0]);
     std::memory_order mo;
     using namespace std::string_view_literals;
@@ -90,9 +96,21 @@ int main(int argc, char* argv[])
         mo = std::memory_order_seq_cst;
     else
         return usage(argv[0]);
-    std::thread t_prod(f_prod, mo);
-    std::thread t_cons(f_cons, mo);
-    t_prod.join();
-    t_cons.join();
+    size_t n = 0;
+    if (argc > 2)
+        n = std::stoull(argv[2]);
+    // created before the threads, so that it counts in them
+    perf::counter_group counters(perf::default_events, true);
+    if (!counters.error().empty())
+        std::cerr << "perf counters: " << counters.error() << std::endl;
+    perf::sample s;
+    {
+        perf::region r{counters, s};
+        std::thread t_prod(f_prod, mo, n);
+        std::thread t_cons(f_cons, mo, n);
+        t_prod.join();
+        t_cons.join();
+    }
+    std::cout << "iterations=" << n << ' ' << s.per(n) << std::endl;
     return EXIT_SUCCESS;
 }
@@ -1,10 +1,15 @@
 /* Effects of different memory order
  * This appears to never fail on x86_64. Maybe it would fail on a weak memory
- * architecture (ARM)?
+ * architecture (ARM)? With argument iterations, it stops after that many
+ * rounds and reports the time and hardware counters per round from
+ * perf_counters.hpp.
  *
  * Compile with C++20 or higher
  */
 
+#include "perf_counters.hpp"
+
+#include <array>
 #include <atomic>
 #include <barrier>
 #include <cstdlib>
@@ -15,8 +20,8 @@
 
 int usage(std::string_view argv0)
 {
-    std::cerr << "usage: " << argv0 << " {relaxed|acq_rel|seq_cst}" <<
-        std::endl;
+    std::cerr << "usage: " << argv0 <<
+        " {relaxed|acq_rel|seq_cst} [iterations]" << std::endl;
     return EXIT_FAILURE;
 }
 
@@ -54,20 +59,21 @@ constexpr size_t num_threads = 4;
 std::barrier end_point(num_threads);
 std::barrier restart_point(num_threads);
 
-void f_write(cnt_t& c, std::memory_order mo)
+// Runs forever if n == 0
+void f_write(cnt_t& c, std::memory_order mo, size_t n)
 {
-    for (;;) {
+    for (size_t i = 0; n == 0 || i < n; ++i) {
         c.fetch_add(1, mo);
         end_point.arrive_and_wait();
         restart_point.arrive_and_wait();
     }
 }
 
-void f_read(cnt_t& a, cnt_t& b, std::memory_order mo, bool leader)
+void f_read(cnt_t& a, cnt_t& b, std::memory_order mo, bool leader, size_t n)
 {
     auto [mr, mw] = mo_rw(mo);
     unsigned long long failures = 0;
-    for (;;) {
+    for (size_t i = 0; n == 0 || i < n; ++i) {
         while (a.load(mr) != expected)
             ;
         if (b.load(mr) == expected)
@@ -90,7 +96,7 @@ void f_read(cnt_t& a, cnt_t& b, std::memory_order mo, bool leader)
 
 int main(int argc, char* argv[])
 {
-    if (argc != 2)
+    if (argc != 2 && argc != 3)
         return usage(argv[0]);
     std::memory_order mo;
     using namespace std::string_view_literals;
@@ -102,13 +108,27 @@ int main(int argc, char* argv[])
         mo = std::memory_order_seq_cst;
     else
         return usage(argv[0]);
-    std::thread t_write1(f_write, std::ref(cnt_a), mo);
-    std::thread t_write2(f_write, std::ref(cnt_b), mo);
-    std::thread t_read1(f_read, std::ref(cnt_a), std::ref(cnt_b), mo, true);
-    std::thread t_read2(f_read, std::ref(cnt_b), std::ref(cnt_a), mo, false);
-    t_write1.join();
-    t_write2.join();
-    t_read1.join();
-    t_read2.join();
+    size_t n = 0;
+    if (argc > 2)
+        n = std::stoull(argv[2]);
+    // created before the threads, so that it counts in them
+    perf::counter_group counters(perf::default_events, true);
+    if (!counters.error().empty())
+        std::cerr << "perf counters: " << counters.error() << std::endl;
+    perf::sample s;
+    {
+        perf::region r{counters, s};
+        std::thread t_write1(f_write, std::ref(cnt_a), mo, n);
+        std::thread t_write2(f_write, std::ref(cnt_b), mo, n);
+        std::thread t_read1(f_read, std::ref(cnt_a), std::ref(cnt_b), mo,
+                            true, n);
+        std::thread t_read2(f_read, std::ref(cnt_b), std::ref(cnt_a), mo,
+                            false, n);
+        t_write1.join();
+        t_write2.join();
+        t_read1.join();
+        t_read2.join();
+    }
+    std::cout << "rounds=" << n << ' ' << s.per(n) << std::endl;
     return EXIT_SUCCESS;
 }
@@ -0,0 +1,117 @@
+/* Construction of data<a, b> from multi_construct_tuple.hpp from tuples
+ * compared to the original tuple_construct, which took the tuple by value and
+ * passed its elements as lvalues, and building data<a, b> in place in
+ * a std::vector and in a clone_arena compared to constructing it on the stack
+ * and pushing it into a std::vector
+ *
+ * Usage: multi_construct_bench [objects]
+ *
+ * Compile with C++17 or higher
+ */
+
+#include "bench.hpp"
+#include "class_clone.hpp"
+#include "multi_construct_tuple.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+template <class B> struct tuple_construct_copy: B {
+    template <class ...A> tuple_construct_copy(std::tuple<A...> t):
+        tuple_construct_copy(std::index_sequence_for<A...>{}, t) {}
+    template <class T, size_t ...I>
+    tuple_construct_copy(std::index_sequence<I...>, T& t):
+        B(std::get<I>(t)...) {}
+};
+
+template <class ...B> struct data_copy: tuple_construct_copy<B>... {
+    template <class ...A>
+    data_copy(A&& ...a): tuple_construct_copy<B>(std::forward<A>(a))... {}
+};
+
+void display(std::string_view method, double ns)
+{
+    std::cout << std::setw(24) << method << std::fixed <<
+        std::setprecision(2) << " ns/object=" << ns << " Mobjects/s=" <<
+        1e3 / ns << std::defaultfloat << std::endl;
+}
+
+int main(int argc, char* argv[])
+{
+    size_t n = 10'000'000;
+    if (argc > 1)
+        n = std::stoull(argv[1]);
+    // long enough not to fit into the small string buffer
+    const std::string text(40, 'x');
+    auto run = [n](std::string_view method, auto f) {
+        display(method, bench::ns_per_op(method, n, f));
+    };
+    // each variant creates the string passed to a from text
+    run("original tuple", [&text](size_t i) {
+        std::string s = text;
+        data_copy<a, b> d{std::tuple{int(i), std::move(s)},
+                          std::tuple{'b', 2.3}};
+        bench::do_not_optimize(d);
+    });
+    run("tuple", [&text](size_t i) {
+        std::string s = text;
+        data<a, b> d{std::tuple{int(i), std::move(s)}, std::tuple{'b', 2.3}};
+        bench::do_not_optimize(d);
+    });
+    run("forward_as_tuple", [&text](size_t i) {
+        std::string s = text;
+        data<a, b> d{std::forward_as_tuple(int(i), std::move(s)),
+                     std::forward_as_tuple('b', 2.3)};
+        bench::do_not_optimize(d);
+    });
+    // objects are built in batches, reusing memory touched before, so that
+    // page faults do not distort the results
+    using data_ab = data<a, b>;
+    constexpr size_t batch = 1000;
+    std::vector<data_ab> v;
+    v.reserve(batch);
+    size_t batches = std::max<size_t>(n / batch, 1);
+    auto run_batches = [batches](std::string_view method, auto f) {
+        display(method, bench::ns_per_op(method, batches, f) / batch);
+    };
+    auto in_batches = [&run_batches, &v](std::string_view method, auto f) {
+        run_batches(method, [&f, &v](size_t) {
+            v.clear();
+            for (size_t i = 0; i < batch; ++i)
+                f(int(i));
+            bench::do_not_optimize(v);
+        });
+    };
+    in_batches("stack, push_back copy", [&text, &v](int i) {
+        data_ab d{std::forward_as_tuple(i, text),
+                  std::forward_as_tuple('b', 2.3)};
+        v.push_back(d);
+    });
+    in_batches("stack, push_back move", [&text, &v](int i) {
+        data_ab d{std::forward_as_tuple(i, text),
+                  std::forward_as_tuple('b', 2.3)};
+        v.push_back(std::move(d));
+    });
+    in_batches("vector emplace_back", [&text, &v](int i) {
+        v.emplace_back(std::forward_as_tuple(i, text),
+                       std::forward_as_tuple('b', 2.3));
+    });
+    run_batches("arena emplace", [&text](size_t) {
+        clone_arena arena;
+        arena.reserve(batch * sizeof(data_ab), alignof(data_ab), batch);
+        for (size_t i = 0; i < batch; ++i) {
+            auto p = arena.emplace<data_ab>(
+                std::forward_as_tuple(int(i), text),
+                std::forward_as_tuple('b', 2.3));
+            bench::do_not_optimize(p);
+        }
+    });
+    return EXIT_SUCCESS;
+}
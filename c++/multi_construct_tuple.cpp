@@ -4,64 +4,73 @@
  * Compile with C++17 or higher
  */
 
+#include "class_clone.hpp"
+#include "multi_construct_tuple.hpp"
+
 #include <iostream>
 #include <string>
 #include <tuple>
-#include <type_traits>
 #include <utility>
+#include <vector>
 
-struct a {
-    a(int i = {}, std::string s = {}): i(i), s(std::move(s)) {}
-    int i;
-    std::string s;
-};
-
-std::ostream& operator<<(std::ostream& o, const a& v)
-{
-    return o << "i=" << v.i << " s=" << v.s;
-}
-
-struct b {
-    b(char c = {}, double d = {}): c(c), d(d) {}
-    char c;
-    double d;
+// Counts copies and moves
+struct counted {
+    explicit counted(int v = {}): v(v) {}
+    counted(const counted& o): v(o.v) {
+        ++copies;
+    }
+    counted(counted&& o) noexcept: v(o.v) {
+        ++moves;
+    }
+    static void reset() {
+        copies = moves = 0;
+    }
+    inline static size_t copies = 0;
+    inline static size_t moves = 0;
+    int v;
 };
 
-std::ostream& operator<<(std::ostream& o, const b& v)
+std::ostream& operator<<(std::ostream& o, const counted& v)
 {
-    return o << "c=" << v.c << " d=" << v.d;
+    return o << "v=" << v.v;
 }
 
-template <class B> struct tuple_construct: B {
-    template <class ...A> tuple_construct(std::tuple<A...> t):
-        tuple_construct(std::index_sequence_for<A...>{}, t) {}
-    template <class T, size_t ...I>
-    tuple_construct(std::index_sequence<I...>, T& t):
-        B(std::get<I>(t)...) {}
-};
-
-template <class ...B> struct data: tuple_construct<B>... {
-    template <class ...A>
-    data(A&& ...a): tuple_construct<B>(std::forward<A>(a))... {}
-};
-
-template <class ...B>
-std::ostream& operator<<(std::ostream& o, const data<B...>& v)
+template <class ...B, class ...T> void count(const char* name, T&& ...t)
 {
-    size_t i = 0;
-    auto write = [&i, &o](auto&& v) {
-        if (i++ != 0)
-            o << ' ';
-        o << v;
-        return 0;
-    };
-   (..., (write(static_cast<const B&>(v))));
-    return o;
+    counted::reset();
+    data<B...> d{std::forward<T>(t)...};
+    std::cout << name << ": " << d << " copies=" << counted::copies <<
+        " moves=" << counted::moves << std::endl;
 }
 
 int main()
 {
     data<a, b> d{std::tuple{1, std::string{"a"}}, std::tuple{'b', 2.3}};
     std::cout << d << std::endl;
+    std::string s{"piecewise"};
+    data<a, b> p{std::forward_as_tuple(2, std::move(s)),
+                 std::forward_as_tuple('c', 4.5)};
+    std::cout << p << std::endl;
+    counted c{3};
+    count<a, counted>("in place", std::forward_as_tuple(1, "x"),
+                      std::forward_as_tuple(3));
+    count<a, counted>("lvalue", std::forward_as_tuple(1, "x"),
+                      std::forward_as_tuple(c));
+    count<a, counted>("rvalue", std::forward_as_tuple(1, "x"),
+                      std::forward_as_tuple(std::move(c)));
+    count<a, counted>("tuple of value", std::tuple{1, "x"}, std::tuple{c});
+    auto t = std::tuple{c};
+    count<a, counted>("lvalue tuple", std::tuple{1, "x"}, t);
+    // built in place inside containers
+    counted::reset();
+    std::vector<data<a, counted>> v;
+    v.reserve(2);
+    v.emplace_back(std::forward_as_tuple(4, "vector"),
+                   std::forward_as_tuple(4));
+    clone_arena arena;
+    auto ap = arena.emplace<data<a, counted>>(
+        std::forward_as_tuple(5, "arena"), std::forward_as_tuple(5));
+    std::cout << "emplace: " << v.back() << ' ' << *ap << " copies=" <<
+        counted::copies << " moves=" << counted::moves << std::endl;
     return 0;
 }
@@ -0,0 +1,74 @@
+#pragma once
+
+/* Tuples passed as arguments to a constructor of a derived template class are
+ * transformed to constructor arguments of base classes.
+ *
+ * Compile with C++17 or higher
+ */
+
+#include <iostream>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+struct a {
+    a(int i = {}, std::string s = {}): i(i), s(std::move(s)) {}
+    int i;
+    std::string s;
+};
+
+inline std::ostream& operator<<(std::ostream& o, const a& v)
+{
+    return o << "i=" << v.i << " s=" << v.s;
+}
+
+struct b {
+    b(char c = {}, double d = {}): c(c), d(d) {}
+    char c;
+    double d;
+};
+
+inline std::ostream& operator<<(std::ostream& o, const b& v)
+{
+    return o << "c=" << v.c << " d=" << v.d;
+}
+
+// Constructs B from the elements of a tuple, like std::piecewise_construct.
+// The elements of an rvalue tuple are forwarded exactly once: an element of
+// type U& as an lvalue, of type U&& or U as an rvalue. Hence, with
+// std::forward_as_tuple, the arguments are not copied or moved at all. The
+// elements of an lvalue tuple are passed as lvalues.
+template <class B> struct tuple_construct: B {
+    template <class ...A> tuple_construct(std::tuple<A...>&& t):
+        tuple_construct(std::index_sequence_for<A...>{}, std::move(t)) {}
+    template <class ...A> tuple_construct(const std::tuple<A...>& t):
+        tuple_construct(std::index_sequence_for<A...>{}, t) {}
+    template <class T, size_t ...I>
+    tuple_construct(std::index_sequence<I...>, T&& t):
+        B(std::get<I>(std::forward<T>(t))...) {}
+};
+
+// Can be constructed in place from tuples, e.g., by emplace_back() of
+// std::vector<data<B...>> or clone_arena::emplace<data<B...>>() from
+// class_clone.hpp
+template <class ...B> struct data: tuple_construct<B>... {
+    // Not used for copying data
+    template <class ...A, class = std::enable_if_t<
+        !(sizeof...(A) == 1 && (... && std::is_same_v<std::decay_t<A>, data>))>>
+    data(A&& ...a): tuple_construct<B>(std::forward<A>(a))... {}
+};
+
+template <class ...B>
+std::ostream& operator<<(std::ostream& o, const data<B...>& v)
+{
+    size_t i = 0;
+    auto write = [&i, &o](auto&& v) {
+        if (i++ != 0)
+            o << ' ';
+        o << v;
+        return 0;
+    };
+   (..., (write(static_cast<const B&>(v))));
+    return o;
+}
@@ -8,6 +8,8 @@
 namespace new_delete {
 
 bool new_called = false;
+size_t new_count = 0;
+size_t new_bytes = 0;
 bool new_log = false;
 bool delete_log = false;
 
@@ -17,6 +19,8 @@ void* operator new(std::size_t sz)
 {
     using namespace new_delete;
     new_called = true;
+    ++new_count;
+    new_bytes += sz;
     static bool recursive = false;
     void* p = malloc(sz);
     if (!recursive && new_log) {
@@ -46,3 +50,41 @@ void operator delete(void* p) noexcept
     }
     free(p);
 }
+
+void* operator new(std::size_t sz, std::align_val_t al)
+{
+    using namespace new_delete;
+    new_called = true;
+    ++new_count;
+    new_bytes += sz;
+    static bool recursive = false;
+    auto a = static_cast<std::size_t>(al);
+    // size passed to aligned_alloc() must be a multiple of alignment
+    void* p = aligned_alloc(a, (sz + a - 1) / a * a);
+    if (!recursive && new_log) {
+        recursive = true;
+        try {
+            std::cout << "new(" << sz << ", " << a << ")=" << p << std::endl;
+        } catch (...) {
+        }
+        recursive = false;
+    }
+    if (!p)
+        throw std::bad_alloc{};
+    return p;
+}
+
+void operator delete(void* p, std::align_val_t) noexcept
+{
+    operator delete(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept
+{
+    operator delete(p);
+}
+
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept
+{
+    operator delete(p);
+}
@@ -5,6 +5,7 @@
  * Compile with C++17 or higher
  */
 
+#include <cstddef>
 #include <cstdlib>
 #include <iostream>
 #include <new>
@@ -12,6 +13,8 @@
 namespace new_delete {
 
 extern bool new_called;
+extern size_t new_count;
+extern size_t new_bytes;
 extern bool new_log;
 extern bool delete_log;
 
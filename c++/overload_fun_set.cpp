@@ -3,13 +3,9 @@
  * Compile with C++20 or higher
  */
 
-#include <iostream>
+#include "overloaded.hpp"
 
-template <class ...T> struct overloaded: T... {
-    using T::operator()...;
-};
-// needed by clang++-15, clang++-17, not needed by g++-11, g++-12
-template <class ...T> overloaded(T&& ...) -> overloaded<T...>;
+#include <iostream>
 
 int main()
 {
@@ -0,0 +1,12 @@
+#pragma once
+
+/* A named set of overloaded functions, built from function objects
+ *
+ * Compile with C++17 or higher
+ */
+
+template <class ...T> struct overloaded: T... {
+    using T::operator()...;
+};
+// needed by clang++-15, clang++-17, not needed by g++-11, g++-12
+template <class ...T> overloaded(T&& ...) -> overloaded<T...>;
@@ -0,0 +1,86 @@
+/* Scaling of parallel_convert_f from parallel_convert.hpp with the number of
+ * threads compared to the serial container_convert_f
+ *
+ * Usage: parallel_convert [max_threads [elements [repeat]]]
+ *   The number of threads, including the calling thread, goes from 2 to
+ *   max_threads (default the number of hardware threads, at least 2).
+ *
+ * Compile with C++20 or higher
+ */
+
+#include "bench.hpp"
+#include "container_convert.hpp"
+#include "flat_set.hpp"
+#include "parallel_convert.hpp"
+#include "thread_pool.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <list>
+#include <random>
+#include <set>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+void display(std::string_view conversion, unsigned threads, double ns,
+             double serial_ns, size_t size)
+{
+    std::cout << std::setw(20) << conversion << " threads=" << std::setw(3) <<
+        threads << std::fixed << std::setprecision(2) << " ms=" << ns / 1e6 <<
+        " speedup=" << serial_ns / ns << std::defaultfloat << " size=" <<
+        size << std::endl;
+}
+
+template <template <class ...> class T, class C>
+void run(std::string_view name, const C& src, unsigned max_threads,
+         size_t repeat)
+{
+    size_t size = 0;
+    auto c = std::string(name) + " threads=";
+    double serial = bench::ns_per_op(c + '1', repeat, [&src, &size](size_t) {
+        auto r = container_convert_f<T>(src);
+        size = r.size();
+        bench::do_not_optimize(r);
+    });
+    display(name, 1, serial, serial, size);
+    for (unsigned threads = 2; threads <= max_threads; threads *= 2) {
+        // the calling thread works, too
+        thread_pool pool(threads - 1);
+        double ns = bench::ns_per_op(c + std::to_string(threads), repeat,
+                                     [&pool, &src, &size](size_t) {
+            auto r = parallel_convert_f<T>(pool, src);
+            size = r.size();
+            bench::do_not_optimize(r);
+        });
+        display(name, threads, ns, serial, size);
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    unsigned max_threads = std::max(std::thread::hardware_concurrency(), 2u);
+    size_t n = 4'000'000;
+    size_t repeat = 3;
+    if (argc > 1)
+        max_threads = std::stoul(argv[1]);
+    if (argc > 2)
+        n = std::stoull(argv[2]);
+    if (argc > 3)
+        repeat = std::stoull(argv[3]);
+    // about one in five elements is a duplicate
+    std::vector<int> v(n);
+    std::mt19937 gen(1);
+    std::uniform_int_distribution<int> dist(0, int(n * 2));
+    for (auto& e: v)
+        e = dist(gen);
+    std::list<int> l(v.begin(), v.end());
+    run<std::set>("vector -> set", v, max_threads, repeat);
+    run<flat_set>("vector -> flat_set", v, max_threads, repeat);
+    run<std::set>("list -> set", l, max_threads, repeat);
+    run<flat_set>("list -> flat_set", l, max_threads, repeat);
+    return EXIT_SUCCESS;
+}
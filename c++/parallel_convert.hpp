@@ -0,0 +1,119 @@
+#pragma once
+
+/* Parallel conversion of a container to an ordered set, e.g., std::set or
+ * flat_set, an extension of container_convert.hpp
+ *
+ * The elements are copied (or moved from an rvalue) into a std::vector, in
+ * parallel chunks if the source has random access iterators. Each chunk is
+ * sorted and deduplicated in parallel, the chunks are merged pairwise in
+ * parallel rounds, and the duplicates across the chunks are removed. The set
+ * is then built from the sorted range in linear time. Sources smaller than
+ * the threshold are converted serially by container_convert_f.
+ *
+ * The value type must be default constructible.
+ *
+ * Compile with C++20 or higher
+ */
+
+#include "container_convert.hpp"
+#include "flat_set.hpp"
+#include "thread_pool.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <ranges>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+inline constexpr size_t parallel_convert_threshold = 64 * 1024;
+
+// Elements of c sorted by comp without duplicates
+template <class C, class Compare>
+auto parallel_sorted_unique(thread_pool& pool, C&& c, Compare comp)
+{
+    using value_type = typename std::decay_t<C>::value_type;
+    constexpr size_t min_chunk = 16 * 1024;
+    constexpr bool move = std::is_rvalue_reference_v<C&&>;
+    size_t n = std::ranges::size(c);
+    size_t chunks = std::clamp(n / min_chunk, size_t(1), pool.size() + 1);
+    std::vector<size_t> bounds(chunks + 1);
+    for (size_t i = 0; i <= chunks; ++i)
+        bounds[i] = n * i / chunks;
+    std::vector<value_type> v;
+    if constexpr (std::ranges::random_access_range<C>) {
+        v.resize(n);
+        parallel_for(pool, chunks, [&](size_t i) {
+            auto first = std::ranges::begin(c) + bounds[i];
+            auto last = std::ranges::begin(c) + bounds[i + 1];
+            if constexpr (move)
+                std::move(first, last, v.begin() + bounds[i]);
+            else
+                std::copy(first, last, v.begin() + bounds[i]);
+        });
+    } else {
+        v.resize(n);
+        if constexpr (move)
+            std::ranges::move(c, v.begin());
+        else
+            std::ranges::copy(c, v.begin());
+    }
+    auto equal = [&comp](const auto& a, const auto& b) { return !comp(a, b); };
+    // after sorting and deduplication, chunk i is [bounds[i], ends[i])
+    std::vector<size_t> ends(chunks);
+    parallel_for(pool, chunks, [&](size_t i) {
+        auto first = v.begin() + bounds[i];
+        auto last = v.begin() + bounds[i + 1];
+        std::sort(first, last, comp);
+        ends[i] = std::unique(first, last, equal) - v.begin();
+    });
+    // merge pairs of adjacent chunks into buf, then swap buf and v
+    std::vector<value_type> buf(chunks > 1 ? n : 0);
+    for (size_t step = 1; step < chunks; step *= 2) {
+        size_t pairs = (chunks + 2 * step - 1) / (2 * step);
+        parallel_for(pool, pairs, [&](size_t p) {
+            size_t a = 2 * p * step;
+            size_t b = a + step;
+            auto src = std::make_move_iterator(v.begin());
+            if (b < chunks)
+                ends[a] = std::merge(src + bounds[a], src + ends[a],
+                                     src + bounds[b], src + ends[b],
+                                     buf.begin() + bounds[a], comp) -
+                    buf.begin();
+            else
+                ends[a] = std::move(v.begin() + bounds[a], v.begin() + ends[a],
+                                    buf.begin() + bounds[a]) - buf.begin();
+        });
+        v.swap(buf);
+    }
+    v.erase(std::unique(v.begin(), v.begin() + ends[0], equal), v.end());
+    return v;
+}
+
+// Converts c to T<value_type>, in parallel if c has at least threshold
+// elements
+template <template <class ...> class T, class C>
+auto parallel_convert_f(thread_pool& pool, C&& c,
+                        size_t threshold = parallel_convert_threshold)
+{
+    using r_type = T<typename std::decay_t<C>::value_type>;
+    if (std::ranges::size(c) < threshold)
+        return container_convert_f<T>(std::forward<C>(c));
+    auto comp = r_type().key_comp();
+    auto v = parallel_sorted_unique(pool, std::forward<C>(c), comp);
+    if constexpr (requires { r_type(sorted_unique, std::move(v), comp); })
+        return r_type(sorted_unique, std::move(v), comp);
+    else
+        return r_type(std::make_move_iterator(v.begin()),
+                      std::make_move_iterator(v.end()), comp);
+}
+
+// A converter for convert(), like container_convert_l
+template <template <class ...> class T>
+auto parallel_convert_l(thread_pool& pool)
+{
+    return [&pool]<class C>(C&& c) {
+        return parallel_convert_f<T>(pool, std::forward<C>(c));
+    };
+}
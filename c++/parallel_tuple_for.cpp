@@ -0,0 +1,118 @@
+/* parallel_tuple_reduce() compared to tuple_for() on a tuple of large
+ * containers, and the cost of scheduling a tiny tuple with and without the
+ * sequential cutoff
+ *
+ * Usage: parallel_tuple_for [max_threads [megabytes_per_element]]
+ *   The number of threads, including the calling thread, goes from 2 to
+ *   max_threads (default the number of hardware threads, at least 2).
+ *
+ * Compile with C++17 or higher
+ */
+
+#include "bench.hpp"
+#include "parallel_tuple_for.hpp"
+#include "thread_pool.hpp"
+#include "tuple_for.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+// The sum of the elements of a container
+struct checksum {
+    template <class C> double operator()(const C& c) const {
+        double s = 0;
+        for (auto v: c)
+            s += v;
+        return s;
+    }
+};
+
+struct size {
+    template <class T> size_t operator()(const T& v) const {
+        if constexpr (has_value_size<T>::value)
+            return v.size();
+        else
+            return 0;
+    }
+};
+
+template <class T> std::vector<T> make_vector(size_t bytes)
+{
+    std::vector<T> v(bytes / sizeof(T));
+    for (size_t i = 0; i < v.size(); ++i)
+        v[i] = T(i % 100);
+    return v;
+}
+
+void display(std::string_view method, unsigned threads, double ns,
+             double result)
+{
+    std::cout << std::setw(22) << method << " threads=" << std::setw(3) <<
+        threads << std::fixed << std::setprecision(3) << " ms=" << ns / 1e6 <<
+        std::defaultfloat << " result=" << result << std::endl;
+}
+
+int main(int argc, char* argv[])
+{
+    unsigned max_threads = std::max(std::thread::hardware_concurrency(), 2u);
+    size_t mb = 16;
+    if (argc > 1)
+        max_threads = std::stoul(argv[1]);
+    if (argc > 2)
+        mb = std::stoull(argv[2]);
+    size_t bytes = mb << 20;
+    std::tuple large{
+        make_vector<int>(bytes), make_vector<double>(bytes),
+        std::string(bytes, 'a'), make_vector<float>(bytes),
+        make_vector<long>(bytes), std::string(bytes, 'b'),
+        make_vector<short>(bytes), make_vector<double>(bytes)
+    };
+    size_t repeat = 5;
+    double result = 0;
+    double ns = bench::ns_per_op("tuple_for", repeat,
+                                 [&large, &result](size_t) {
+        double s = 0;
+        tuple_for([&s](const auto& c) { s += checksum()(c); }, large);
+        result = s;
+        bench::do_not_optimize(result);
+    });
+    display("tuple_for", 1, ns, result);
+    for (unsigned threads = 2; threads <= max_threads; threads *= 2) {
+        // the calling thread works, too
+        thread_pool pool(threads - 1);
+        auto name = "parallel_tuple_reduce threads=" + std::to_string(threads);
+        ns = bench::ns_per_op(name, repeat, [&pool, &large, &result](size_t) {
+            result = parallel_tuple_reduce(pool, large, 0.0, checksum());
+            bench::do_not_optimize(result);
+        });
+        display("parallel_tuple_reduce", threads, ns, result);
+    }
+    thread_pool pool(max_threads - 1);
+    std::tuple tiny{1, std::string{"abc"}, std::vector<int>{1, 2}};
+    repeat = 100'000;
+    size_t sz = 0;
+    ns = bench::ns_per_op("tiny tuple with cutoff", repeat,
+                          [&pool, &tiny, &sz](size_t) {
+        sz = parallel_tuple_reduce(pool, tiny, size_t(0), size());
+        bench::do_not_optimize(sz);
+    });
+    std::cout << "tiny tuple with cutoff ns=" << ns << " size=" << sz <<
+        std::endl;
+    ns = bench::ns_per_op("tiny tuple without cutoff", repeat,
+                          [&pool, &tiny, &sz](size_t) {
+        sz = parallel_tuple_reduce(pool, tiny, size_t(0), size(), std::plus<>(),
+                                   parallel_cutoff{0, 0});
+        bench::do_not_optimize(sz);
+    });
+    std::cout << "tiny tuple without cutoff ns=" << ns << " size=" << sz <<
+        std::endl;
+    return EXIT_SUCCESS;
+}
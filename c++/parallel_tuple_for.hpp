@@ -0,0 +1,114 @@
+#pragma once
+
+/* Call a visitor for each value in a std::tuple concurrently on a thread pool
+ *
+ * The elements must be independent and the visitor must be safe to call from
+ * several threads at once. A stateful visitor, like the size visitor in
+ * tuple_for.cpp, should be turned into a function returning a partial result
+ * for each element and used by parallel_tuple_reduce(), which combines the
+ * partial results in the order of the elements.
+ *
+ * Scheduling costs a few microseconds, hence a tuple with fewer elements
+ * than parallel_cutoff::min_elements, or with elements smaller than
+ * parallel_cutoff::min_bytes in total, is visited sequentially by the calling
+ * thread. The size of an element is estimated by footprint().
+ *
+ * Compile with C++17 or higher
+ */
+
+#include "thread_pool.hpp"
+#include "tuple_for.hpp"
+
+#include <array>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <optional>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+struct parallel_cutoff {
+    size_t min_elements = 2;
+    size_t min_bytes = 256 * 1024;
+};
+
+template <class T, class = void> struct has_value_size: std::false_type {};
+template <class T> struct has_value_size<T, std::void_t<
+    typename T::value_type, decltype(std::size(std::declval<const T&>()))>>:
+    std::true_type {};
+
+// The size of v and, for a container, of its elements
+template <class T> size_t footprint(const T& v)
+{
+    if constexpr (has_value_size<T>::value)
+        return sizeof(T) + std::size(v) * sizeof(typename T::value_type);
+    else
+        return sizeof(T);
+}
+
+template <class T> bool run_parallel(const T& t, parallel_cutoff cutoff)
+{
+    if (std::tuple_size_v<T> < cutoff.min_elements)
+        return false;
+    size_t bytes = 0;
+    tuple_for([&bytes](const auto& v) { bytes += footprint(v); }, t);
+    return bytes >= cutoff.min_bytes;
+}
+
+// Calls g(std::integral_constant<size_t, I>{}) for I in 0...N-1 by
+// parallel_for()
+template <class G, size_t ...I>
+void parallel_invoke_indexed(thread_pool& pool, G& g, std::index_sequence<I...>)
+{
+    using call_type = void (*)(G&);
+    static constexpr call_type calls[] = {[](G& g) {
+        g(std::integral_constant<size_t, I>{});
+    }...};
+    parallel_for(pool, sizeof...(I), [&g](size_t i) { calls[i](g); });
+}
+
+// Calls f(std::get<I>(t)) for all I in parallel
+template <class F, class T>
+void parallel_tuple_for(thread_pool& pool, F&& f, T&& t,
+                        parallel_cutoff cutoff = {})
+{
+    using tuple_type = std::decay_t<T>;
+    constexpr size_t n = std::tuple_size_v<tuple_type>;
+    if constexpr (n > 0) {
+        if (!run_parallel<tuple_type>(t, cutoff)) {
+            tuple_for(std::forward<F>(f), std::forward<T>(t));
+            return;
+        }
+        auto g = [&f, &t](auto i) {
+            f(std::get<i>(std::forward<T>(t)));
+        };
+        parallel_invoke_indexed(pool, g, std::make_index_sequence<n>{});
+    }
+}
+
+// Returns op(...op(op(init, f(std::get<0>(t))), f(std::get<1>(t)))...),
+// calling f for all elements in parallel
+template <class R, class F, class T, class Op = std::plus<>>
+R parallel_tuple_reduce(thread_pool& pool, T&& t, R init, F&& f, Op op = {},
+                        parallel_cutoff cutoff = {})
+{
+    using tuple_type = std::decay_t<T>;
+    constexpr size_t n = std::tuple_size_v<tuple_type>;
+    if constexpr (n > 0) {
+        if (!run_parallel<tuple_type>(t, cutoff)) {
+            tuple_for([&](auto&& v) {
+                init = op(std::move(init), f(std::forward<decltype(v)>(v)));
+            }, std::forward<T>(t));
+            return init;
+        }
+        std::array<std::optional<R>, n> partial;
+        auto g = [&f, &t, &partial](auto i) {
+            partial[i].emplace(f(std::get<i>(std::forward<T>(t))));
+        };
+        parallel_invoke_indexed(pool, g, std::make_index_sequence<n>{});
+        for (auto& p: partial)
+            init = op(std::move(init), std::move(*p));
+    }
+    return init;
+}
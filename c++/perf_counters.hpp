@@ -0,0 +1,202 @@
+#pragma once
+
+/* Hardware performance counters by Linux perf_event_open(2)
+ *
+ * perf::counter_group opens a group of counters for the calling thread, and
+ * with inherit also for threads created after opening the group. Events
+ * that cannot be opened, because the kernel does not permit it (see
+ * /proc/sys/kernel/perf_event_paranoid) or the CPU does not support them,
+ * are skipped, and error() tells why. Only user space is counted. start()
+ * and stop() delimit a measured region, stop() returns a sample with the
+ * elapsed time and the values of the opened counters, scaled if the kernel
+ * multiplexed them. Without any counter, the sample contains only the time.
+ * perf::region does start() and stop() in its constructor and destructor.
+ *
+ * Compile with C++17 or higher, on Linux
+ */
+
+#include "bench.hpp"
+
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <iomanip>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace perf {
+
+enum class event {
+    cycles,
+    instructions,
+    cache_references,
+    cache_misses,
+    branches,
+    branch_misses,
+};
+
+inline std::string_view name(event e)
+{
+    switch (e) {
+    case event::cycles:
+        return "cycles";
+    case event::instructions:
+        return "instructions";
+    case event::cache_references:
+        return "cache_references";
+    case event::cache_misses:
+        return "cache_misses";
+    case event::branches:
+        return "branches";
+    case event::branch_misses:
+        return "branch_misses";
+    }
+    return "unknown";
+}
+
+inline uint64_t config(event e)
+{
+    switch (e) {
+    case event::cycles:
+        return PERF_COUNT_HW_CPU_CYCLES;
+    case event::instructions:
+        return PERF_COUNT_HW_INSTRUCTIONS;
+    case event::cache_references:
+        return PERF_COUNT_HW_CACHE_REFERENCES;
+    case event::cache_misses:
+        return PERF_COUNT_HW_CACHE_MISSES;
+    case event::branches:
+        return PERF_COUNT_HW_BRANCH_INSTRUCTIONS;
+    case event::branch_misses:
+        return PERF_COUNT_HW_BRANCH_MISSES;
+    }
+    return PERF_COUNT_HW_CPU_CYCLES;
+}
+
+inline const std::vector<event> default_events{
+    event::cycles, event::instructions, event::cache_misses,
+    event::branch_misses,
+};
+
+struct sample {
+    double ns = 0;
+    std::vector<std::pair<event, double>> values;
+    // The sample divided by the number of iterations n
+    sample per(size_t n) const {
+        sample r = *this;
+        r.ns /= double(n);
+        for (auto& v: r.values)
+            v.second /= double(n);
+        return r;
+    }
+};
+
+inline std::ostream& operator<<(std::ostream& os, const sample& s)
+{
+    auto flags = os.flags();
+    auto precision = os.precision();
+    os << std::fixed << std::setprecision(2) << "ns=" << s.ns;
+    for (auto& [e, v]: s.values)
+        os << ' ' << name(e) << '=' << v;
+    os.flags(flags);
+    os.precision(precision);
+    return os;
+}
+
+class counter_group {
+public:
+    explicit counter_group(const std::vector<event>& events = default_events,
+                           bool inherit = false) {
+        for (auto e: events) {
+            perf_event_attr attr{};
+            attr.size = sizeof(attr);
+            attr.type = PERF_TYPE_HARDWARE;
+            attr.config = config(e);
+            attr.disabled = fds.empty();
+            attr.inherit = inherit;
+            attr.exclude_kernel = 1;
+            attr.exclude_hv = 1;
+            attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED |
+                PERF_FORMAT_TOTAL_TIME_RUNNING;
+            int fd = int(syscall(SYS_perf_event_open, &attr, 0, -1,
+                                 fds.empty() ? -1 : fds.front(), 0));
+            if (fd < 0) {
+                if (err.empty())
+                    err = std::string(name(e)) + ": " + std::strerror(errno);
+                continue;
+            }
+            fds.push_back(fd);
+            opened.push_back(e);
+        }
+    }
+    counter_group(const counter_group&) = delete;
+    counter_group& operator=(const counter_group&) = delete;
+    ~counter_group() {
+        for (auto fd: fds)
+            close(fd);
+    }
+    // Whether at least one counter is open
+    bool available() const noexcept {
+        return !fds.empty();
+    }
+    // The reason why the first event that failed could not be opened
+    const std::string& error() const noexcept {
+        return err;
+    }
+    void start() {
+        if (available()) {
+            ioctl(fds.front(), PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+            ioctl(fds.front(), PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+        }
+        t0 = bench::clock::now();
+    }
+    sample stop() {
+        sample s;
+        s.ns = bench::ns_since(t0);
+        if (!available())
+            return s;
+        ioctl(fds.front(), PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+        for (size_t i = 0; i < fds.size(); ++i) {
+            // value, time enabled, time running
+            uint64_t v[3] = {};
+            if (read(fds[i], v, sizeof(v)) != ssize_t(sizeof(v)))
+                continue;
+            double value = double(v[0]);
+            if (v[2] > 0 && v[2] < v[1])
+                value *= double(v[1]) / double(v[2]);
+            s.values.emplace_back(opened[i], value);
+        }
+        return s;
+    }
+private:
+    std::vector<int> fds; // the first is the group leader
+    std::vector<event> opened;
+    std::string err;
+    bench::clock::time_point t0;
+};
+
+// Measures its lifetime into a sample
+class region {
+public:
+    region(counter_group& g, sample& s): g(g), s(s) {
+        g.start();
+    }
+    region(const region&) = delete;
+    region& operator=(const region&) = delete;
+    ~region() {
+        s = g.stop();
+    }
+private:
+    counter_group& g;
+    sample& s;
+};
+
+}
@@ -0,0 +1,175 @@
+/* A vector of polymorphic_value compared to a vector of std::shared_ptr in
+ * copying, iteration, and virtual function calls
+ *
+ * Usage: polymorphic_value [elements [repeat]]
+ *
+ * Compile with C++17 or higher
+ */
+
+#include "bench.hpp"
+#include "class_clone.hpp"
+#include "polymorphic_value.hpp"
+
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+class counter: public clonable<counter> {
+public:
+    explicit counter(int i = {}): clonable(std::tuple<>{}), i(i) {}
+    virtual long value() const {
+        return i;
+    }
+    int i;
+};
+
+class counter2: public clonable<counter2, counter> {
+public:
+    explicit counter2(int i = {}): clonable(i) {}
+    long value() const override {
+        return 2 * i;
+    }
+};
+
+class counter_str: public clonable<counter_str, counter> {
+public:
+    explicit counter_str(int i = {}, std::string s = {}):
+        clonable(i), s(std::move(s)) {}
+    long value() const override {
+        return i + long(s.size());
+    }
+    std::string s;
+};
+
+void display(std::string_view container, std::string_view op, size_t n,
+             double ns, long sum = 0)
+{
+    std::cout << std::setw(32) << container << std::setw(10) << op <<
+        std::fixed << std::setprecision(2) << " ns/element=" << ns / n <<
+        std::defaultfloat;
+    if (sum != 0)
+        std::cout << " sum=" << sum;
+    std::cout << std::endl;
+}
+
+// f(i) creates the i-th element
+template <class C, class F>
+void run(std::string_view name, size_t n, size_t repeat, F f)
+{
+    C v;
+    v.reserve(n);
+    for (size_t i = 0; i < n; ++i)
+        v.push_back(f(i));
+    auto c = std::string(name) + ' ';
+    display(name, "copy", n,
+            bench::ns_per_op(c + "copy", repeat, [&v](size_t) {
+        C c = v;
+        bench::do_not_optimize(c);
+    }));
+    long sum = 0;
+    double ns = bench::ns_per_op(c + "iterate", repeat, [&v, &sum](size_t) {
+        for (auto& p: v)
+            sum += p->i;
+        bench::do_not_optimize(sum);
+    });
+    display(name, "iterate", n, ns, sum);
+    sum = 0;
+    ns = bench::ns_per_op(c + "virtual", repeat, [&v, &sum](size_t) {
+        for (auto& p: v)
+            sum += p->value();
+        bench::do_not_optimize(sum);
+    });
+    display(name, "virtual", n, ns, sum);
+}
+
+// Copies from const objects, inline and on the heap, returns whether the
+// copies have the values of the originals
+bool check_const_copies()
+{
+    const counter2 c(21);
+    polymorphic_value<counter, 32> v(c);
+    const counter_str s(1, std::string(100, 'x'));
+    polymorphic_value<counter, 32> h(s);
+    return v.is_inline() && v->value() == 42 && !h.is_inline() &&
+        h->value() == 101 && s.s.size() == 100;
+}
+
+// Moves an rvalue too big to be stored inline, and copies an object held by
+// clonable_base, returns whether the results have the expected values
+bool check_heap_move_and_base()
+{
+    counter_str s(1, std::string(100, 'x'));
+    polymorphic_value<counter, 32> h(std::move(s));
+    polymorphic_value<clonable_base> b(counter2(21));
+    polymorphic_value<clonable_base> c = b;
+    return !h.is_inline() && h->value() == 101 && s.s.empty() &&
+        c.is_inline() && static_cast<const counter&>(*c).value() == 42;
+}
+
+int main(int argc, char* argv[])
+{
+    size_t n = 1'000'000;
+    size_t repeat = 10;
+    if (argc > 1)
+        n = std::stoull(argv[1]);
+    if (argc > 2)
+        repeat = std::stoull(argv[2]);
+    if (!check_const_copies()) {
+        std::cerr << "copying a const object failed" << std::endl;
+        return EXIT_FAILURE;
+    }
+    if (!check_heap_move_and_base()) {
+        std::cerr << "moving to the heap or holding clonable_base failed" <<
+            std::endl;
+        return EXIT_FAILURE;
+    }
+    // every 8th object is a counter_str
+    auto make = [](auto wrap) {
+        return [wrap](size_t i) {
+            int v = int(i);
+            switch (i % 8) {
+            case 0:
+                return wrap(counter_str(v, "abc"));
+            case 1:
+            case 3:
+            case 5:
+                return wrap(counter2(v));
+            default:
+                return wrap(counter(v));
+            }
+        };
+    };
+    auto shared = make([](auto&& o) -> std::shared_ptr<counter> {
+        return std::make_shared<std::decay_t<decltype(o)>>(std::move(o));
+    });
+    run<std::vector<std::shared_ptr<counter>>>("vector<shared_ptr>", n, repeat,
+                                               shared);
+    {
+        std::vector<std::shared_ptr<counter>> v;
+        v.reserve(n);
+        for (size_t i = 0; i < n; ++i)
+            v.push_back(shared(i));
+        display("vector<shared_ptr>", "clone", n,
+                bench::ns_per_op("vector<shared_ptr> clone", repeat,
+                                 [&v](size_t) {
+                    std::vector<std::shared_ptr<counter>> c;
+                    c.reserve(v.size());
+                    for (auto& p: v)
+                        c.push_back(p->clone());
+                    bench::do_not_optimize(c);
+                }));
+    }
+    using pv32 = polymorphic_value<counter, 32>;
+    run<std::vector<pv32>>("vector<polymorphic_value<32>>", n, repeat,
+                           make([](auto&& o) { return pv32(std::move(o)); }));
+    using pv64 = polymorphic_value<counter, 64>;
+    run<std::vector<pv64>>("vector<polymorphic_value<64>>", n, repeat,
+                           make([](auto&& o) { return pv64(std::move(o)); }));
+    return EXIT_SUCCESS;
+}
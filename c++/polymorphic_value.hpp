@@ -0,0 +1,125 @@
+#pragma once
+
+/* A polymorphic object with value semantics, built on the clonable hierarchy
+ * from class_clone.hpp
+ *
+ * polymorphic_value<Base, InlineSize> owns an object of class Base or of
+ * a class derived from Base. Copying the polymorphic_value copies the object.
+ * An object is stored inline if it fits into InlineSize bytes with alignment
+ * of std::max_align_t and is nothrow move constructible. Otherwise, it is
+ * stored in a heap block of its size and alignment. An object is copied by
+ * clonable::clone_at(), moved from an rvalue by clonable::move_to(), and
+ * destroyed by clonable::destroy_at(), hence Base may be clonable_base, which
+ * has a protected destructor. Moving a polymorphic_value never allocates: an
+ * inline object is moved by move_to() and a heap object is passed by
+ * a pointer.
+ *
+ * Compile with C++17 or higher
+ */
+
+#include "class_clone.hpp"
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+template <class Base, size_t InlineSize = 4 * sizeof(void*)>
+class polymorphic_value {
+public:
+    polymorphic_value() noexcept = default;
+    template <class D, class = std::enable_if_t<
+        std::is_base_of_v<Base, std::remove_cv_t<std::remove_reference_t<D>>>>>
+    polymorphic_value(D&& v) {
+        if constexpr (std::is_rvalue_reference_v<D&&> &&
+                      !std::is_const_v<std::remove_reference_t<D>>)
+        {
+            Base& b = v;
+            emplace(b, [&b](void* m) { return b.move_to(m); });
+        } else {
+            const Base& b = v;
+            emplace(b, [&b](void* m) { return b.clone_at(m); });
+        }
+    }
+    polymorphic_value(const polymorphic_value& o) {
+        if (o.p) {
+            const Base& b = *o.p;
+            emplace(b, [&b](void* m) { return b.clone_at(m); });
+        }
+    }
+    polymorphic_value(polymorphic_value&& o) noexcept {
+        steal(o);
+    }
+    ~polymorphic_value() {
+        reset();
+    }
+    polymorphic_value& operator=(const polymorphic_value& o) {
+        if (this != &o)
+            *this = polymorphic_value(o);
+        return *this;
+    }
+    polymorphic_value& operator=(polymorphic_value&& o) noexcept {
+        if (this != &o) {
+            reset();
+            steal(o);
+        }
+        return *this;
+    }
+    void reset() noexcept {
+        if (p) {
+            auto align = std::align_val_t(p->clone_layout().align);
+            p->destroy_at();
+            if (heap)
+                ::operator delete(heap, align);
+            p = nullptr;
+            heap = nullptr;
+        }
+    }
+    Base* get() noexcept { return p; }
+    const Base* get() const noexcept { return p; }
+    Base& operator*() noexcept { return *p; }
+    const Base& operator*() const noexcept { return *p; }
+    Base* operator->() noexcept { return p; }
+    const Base* operator->() const noexcept { return p; }
+    explicit operator bool() const noexcept { return p; }
+    // Whether the object is stored inline
+    bool is_inline() const noexcept { return p && !heap; }
+private:
+    static bool fits_inline(const Base& b) noexcept {
+        auto l = b.clone_layout();
+        return l.size <= InlineSize &&
+            alignof(std::max_align_t) % l.align == 0 && l.nothrow_move;
+    }
+    // Creates the object by make(memory) inline or in a new heap block, with
+    // the layout of b
+    template <class F> void emplace(const Base& b, F make) {
+        if (fits_inline(b)) {
+            p = make(buf);
+            return;
+        }
+        auto l = b.clone_layout();
+        void* m = ::operator new(l.size, std::align_val_t(l.align));
+        try {
+            p = make(m);
+        } catch (...) {
+            ::operator delete(m, std::align_val_t(l.align));
+            throw;
+        }
+        heap = m;
+    }
+    // Moves the object of o to this, which must be empty
+    void steal(polymorphic_value& o) noexcept {
+        if (o.p) {
+            if (o.heap) {
+                p = std::exchange(o.p, nullptr);
+                heap = std::exchange(o.heap, nullptr);
+            } else {
+                p = o.p->move_to(buf);
+                o.reset();
+            }
+        }
+    }
+    alignas(std::max_align_t) std::byte buf[InlineSize];
+    Base* p = nullptr;
+    void* heap = nullptr; // the block of a heap object
+};
@@ -0,0 +1,80 @@
+/* Probes from probe.hpp in several threads, and the cost of a probe
+ *
+ * Usage: probe [iterations [threads]]
+ *
+ * Compile with C++20 or higher
+ */
+
+#include "bench.hpp"
+#include "probe.hpp"
+
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+unsigned long work(size_t i)
+{
+    PROBE("work");
+    unsigned long r = i;
+    for (int k = 0; k < 10; ++k)
+        r = r * 6364136223846793005 + 1442695040888963407;
+    if (r % 2)
+        PROBE_COUNT("work odd");
+    return r;
+}
+
+void display(std::string_view method, double ns)
+{
+    std::cout << std::setw(12) << method << std::fixed <<
+        std::setprecision(2) << " ns/iteration=" << ns << std::defaultfloat <<
+        std::endl;
+}
+
+int main(int argc, char* argv[])
+{
+    size_t n = 100'000'000;
+    size_t threads = 4;
+    if (argc > 1)
+        n = std::stoull(argv[1]);
+    if (argc > 2)
+        threads = std::stoull(argv[2]);
+    unsigned long sum = 0;
+    auto run = [n](std::string_view method, auto f) {
+        display(method, bench::ns_per_op(method, n, f));
+    };
+    run("no probe", [&sum](size_t i) {
+        sum += i * i;
+        bench::do_not_optimize(sum);
+    });
+    run("PROBE_COUNT", [&sum](size_t i) {
+        PROBE_COUNT("loop");
+        sum += i * i;
+        bench::do_not_optimize(sum);
+    });
+    run("PROBE", [&sum](size_t i) {
+        PROBE("loop timed");
+        sum += i * i;
+        bench::do_not_optimize(sum);
+    });
+    // the counts of the joined threads are kept
+    std::vector<std::thread> pool;
+    for (size_t t = 0; t < threads; ++t)
+        pool.emplace_back([t] {
+            unsigned long s = 0;
+            for (size_t i = 0; i < 1'000'000; ++i)
+                s += work(i + t);
+            bench::do_not_optimize(s);
+        });
+    for (auto& t: pool)
+        t.join();
+    // the counts of the running main thread are added to them
+    for (size_t i = 0; i < 1000; ++i)
+        sum += work(i);
+    bench::do_not_optimize(sum);
+    probe::write_csv(std::cout, probe::snapshot());
+    return EXIT_SUCCESS;
+}
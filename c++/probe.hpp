@@ -0,0 +1,188 @@
+#pragma once
+
+/* Always-on instrumentation probes for hot paths
+ *
+ * PROBE("name") counts executions of the enclosing scope and measures its
+ * total duration. PROBE_COUNT("name") only counts. Each use of the macros is
+ * a separate site. unique from unique_type.hpp gives each site its own type,
+ * and so its own thread-local counter, aligned to a cache line. Incrementing
+ * it needs no lookup and no atomic read-modify-write. A counter is registered
+ * in a global list on its first use in a thread. When the thread exits, its
+ * counts are added to totals kept for the site.
+ *
+ * probe::snapshot() walks all sites and returns their counts summed over all
+ * threads. probe::write_csv() exports a snapshot.
+ *
+ * A probe in a template creates a separate site for each instantiation, and
+ * all of them have the same name.
+ *
+ * Compile with C++20 or higher
+ */
+
+#include "unique_type.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <ostream>
+#include <string_view>
+#include <vector>
+
+namespace probe {
+
+using clock = std::chrono::steady_clock;
+
+// Counts of a site summed over all threads
+struct record {
+    std::string_view name;
+    std::string_view file;
+    unsigned line;
+    uint64_t count;
+    uint64_t ns;
+};
+
+// The totals of a site from threads that have exited, guarded by the
+// registry mutex
+struct site {
+    const char* name = nullptr;
+    const char* file = nullptr;
+    unsigned line = 0;
+    size_t index = 0; // in the list of sites
+    uint64_t count = 0;
+    uint64_t ns = 0;
+};
+
+// Written only by its thread, read by snapshot() from any thread, so that
+// relaxed loads and stores are enough
+struct alignas(64) counter {
+    void add(uint64_t ns_elapsed) noexcept {
+        count.store(count.load(std::memory_order_relaxed) + 1,
+                    std::memory_order_relaxed);
+        ns.store(ns.load(std::memory_order_relaxed) + ns_elapsed,
+                 std::memory_order_relaxed);
+    }
+    void add() noexcept {
+        count.store(count.load(std::memory_order_relaxed) + 1,
+                    std::memory_order_relaxed);
+    }
+    std::atomic<uint64_t> count{0};
+    std::atomic<uint64_t> ns{0};
+    site* owner = nullptr; // null until registered
+};
+
+struct registry {
+    std::mutex mtx;
+    std::vector<site*> sites;
+    std::vector<counter*> counters;
+};
+
+// Never destroyed, because threads may exit during destruction of statics
+inline registry& global_registry()
+{
+    static registry* r = new registry;
+    return *r;
+}
+
+// Moves the counts of the counters of a thread to their sites at thread exit
+class thread_counters {
+public:
+    thread_counters() = default;
+    thread_counters(const thread_counters&) = delete;
+    thread_counters& operator=(const thread_counters&) = delete;
+    ~thread_counters() {
+        auto& r = global_registry();
+        std::lock_guard lck{r.mtx};
+        for (auto c: own) {
+            c->owner->count += c->count.load(std::memory_order_relaxed);
+            c->owner->ns += c->ns.load(std::memory_order_relaxed);
+            std::erase(r.counters, c);
+        }
+    }
+    std::vector<counter*> own;
+};
+
+inline void register_counter(counter& c, site& s, const char* name,
+                             const char* file, unsigned line)
+{
+    thread_local thread_counters local;
+    auto& r = global_registry();
+    std::lock_guard lck{r.mtx};
+    if (!s.name) {
+        s.name = name;
+        s.file = file;
+        s.line = line;
+        s.index = r.sites.size();
+        r.sites.push_back(&s);
+    }
+    r.counters.push_back(&c);
+    local.own.push_back(&c);
+    c.owner = &s;
+}
+
+// One site and one counter per thread for each type Tag
+template <class Tag> inline constinit site site_of{};
+
+template <class Tag>
+counter& local(const char* name, const char* file, unsigned line)
+{
+    static constinit thread_local Tag slot{};
+    if (!slot.val.owner) [[unlikely]]
+        register_counter(slot.val, site_of<Tag>, name, file, line);
+    return slot.val;
+}
+
+// Counts a scope and measures its duration
+class scope {
+public:
+    explicit scope(counter& c) noexcept: c(c), start(clock::now()) {}
+    scope(const scope&) = delete;
+    scope& operator=(const scope&) = delete;
+    ~scope() {
+        c.add(uint64_t(std::chrono::nanoseconds(clock::now() - start).
+                       count()));
+    }
+private:
+    counter& c;
+    clock::time_point start;
+};
+
+// Counts of all sites in the order of registration
+inline std::vector<record> snapshot()
+{
+    auto& r = global_registry();
+    std::lock_guard lck{r.mtx};
+    std::vector<record> result;
+    result.reserve(r.sites.size());
+    for (auto s: r.sites)
+        result.push_back({s->name, s->file, s->line, s->count, s->ns});
+    for (auto c: r.counters) {
+        auto& rec = result[c->owner->index];
+        rec.count += c->count.load(std::memory_order_relaxed);
+        rec.ns += c->ns.load(std::memory_order_relaxed);
+    }
+    return result;
+}
+
+inline void write_csv(std::ostream& os, const std::vector<record>& records)
+{
+    os << "name,file,line,count,ns\n";
+    for (auto& r: records)
+        os << r.name << ',' << r.file << ',' << r.line << ',' << r.count <<
+            ',' << r.ns << '\n';
+}
+
+}
+
+#define PROBE_CONCAT_IMPL(a, b) a##b
+#define PROBE_CONCAT(a, b) PROBE_CONCAT_IMPL(a, b)
+
+// __COUNTER__ names the scope variable, so that several probes may be on
+// one line
+#define PROBE(name) \
+    ::probe::scope PROBE_CONCAT(probe_scope_, __COUNTER__){ \
+        ::probe::local<::unique<::probe::counter>>(name, __FILE__, __LINE__)}
+
+#define PROBE_COUNT(name) \
+    ::probe::local<::unique<::probe::counter>>(name, __FILE__, __LINE__).add()
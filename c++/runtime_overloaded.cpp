@@ -0,0 +1,158 @@
+/* Calls of runtime_overloaded from runtime_overloaded.hpp, with a hash table
+ * lookup on each call and with an inline cache at the call site, compared to
+ * calls of a static overloaded from overloaded.hpp
+ *
+ * The call sites see pairs of a single combination of types, which is the
+ * best case for the cache, or of random combinations of 3 x 3 types, which is
+ * the worst case.
+ *
+ * Usage: runtime_overloaded [calls [repeat]]
+ *
+ * Compile with C++17 or higher
+ */
+
+#include "bench.hpp"
+#include "overloaded.hpp"
+#include "runtime_overloaded.hpp"
+
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+struct shape {
+    explicit shape(double size): size(size) {}
+    virtual ~shape() = default;
+    double size;
+};
+
+struct circle: shape {
+    using shape::shape;
+};
+
+struct square: shape {
+    using shape::shape;
+};
+
+struct triangle: shape {
+    using shape::shape;
+};
+
+using collide_t = runtime_overloaded<double, shape>;
+
+void display(std::string_view types, std::string_view method, double ns,
+             double sum)
+{
+    std::cout << std::setw(6) << types << std::setw(18) << method <<
+        std::fixed << std::setprecision(2) << " ns/call=" << ns <<
+        std::defaultfloat << " sum=" << sum << std::endl;
+}
+
+template <class F>
+void run(std::string_view types, std::string_view method, size_t n,
+         size_t repeat, F f)
+{
+    double sum = 0;
+    auto name = std::string(types) + ' ' + std::string(method);
+    double ns = bench::ns_per_op(name, repeat, [&f, &sum](size_t) {
+        sum = f();
+        bench::do_not_optimize(sum);
+    }) / n;
+    display(types, method, ns, sum);
+}
+
+using pairs_t = std::vector<std::pair<const shape*, const shape*>>;
+
+void run_dynamic(std::string_view types, const collide_t& collide,
+                 const pairs_t& pairs, size_t repeat)
+{
+    run(types, "unordered_map", pairs.size(), repeat, [&collide, &pairs] {
+        double s = 0;
+        for (auto [a, b]: pairs)
+            s += collide(*a, *b);
+        return s;
+    });
+    run(types, "inline cache", pairs.size(), repeat, [&collide, &pairs] {
+        static thread_local collide_t::cache c;
+        double s = 0;
+        for (auto [a, b]: pairs)
+            s += collide(c, *a, *b);
+        return s;
+    });
+}
+
+int main(int argc, char* argv[])
+{
+    size_t n = 1'000'000;
+    size_t repeat = 10;
+    if (argc > 1)
+        n = std::stoull(argv[1]);
+    if (argc > 2)
+        repeat = std::stoull(argv[2]);
+    collide_t collide;
+    collide.
+        add<circle, circle>([](auto& a, auto& b) { return a.size + b.size; }).
+        add<circle, square>([](auto& a, auto& b) { return a.size - b.size; }).
+        add<square, circle>([](auto& a, auto& b) { return b.size - a.size; }).
+        add<square, square>([](auto& a, auto& b) { return a.size * b.size; });
+    collide_t::cache c;
+    circle c1{1.0};
+    square s1{2.0};
+    triangle t1{3.0};
+    std::cout << "circle, square: " << collide(c, c1, s1) << std::endl;
+    collide.add<circle, square>([](auto& a, auto& b) {
+        return a.size * b.size;
+    });
+    std::cout << "circle, square after add: " << collide(c, c1, s1) <<
+        std::endl;
+    try {
+        collide(c, c1, t1);
+    } catch (const std::bad_function_call&) {
+        std::cout << "circle, triangle: no handler" << std::endl;
+    }
+    collide.
+        add<circle, triangle>([](auto& a, auto& b) { return a.size / b.size; }).
+        add<square, triangle>([](auto& a, auto& b) { return b.size / a.size; }).
+        add<triangle, circle>([](auto& a, auto&) { return a.size; }).
+        add<triangle, square>([](auto&, auto& b) { return b.size; }).
+        add<triangle, triangle>([](auto&, auto&) { return 1.0; });
+    // objects of all types and sizes 1.0, ..., 10.0
+    std::vector<std::unique_ptr<shape>> shapes;
+    for (int i = 0; i < 10; ++i) {
+        shapes.push_back(std::make_unique<circle>(i + 1));
+        shapes.push_back(std::make_unique<square>(i + 1));
+        shapes.push_back(std::make_unique<triangle>(i + 1));
+    }
+    std::mt19937 gen(1);
+    std::uniform_int_distribution<size_t> index(0, shapes.size() - 1);
+    std::uniform_int_distribution<size_t> size(0, 9);
+    pairs_t same;
+    pairs_t mixed;
+    same.reserve(n);
+    mixed.reserve(n);
+    for (size_t i = 0; i < n; ++i) {
+        same.emplace_back(shapes[3 * size(gen)].get(),
+                          shapes[3 * size(gen) + 1].get());
+        mixed.emplace_back(shapes[index(gen)].get(), shapes[index(gen)].get());
+    }
+    // the static types are known, but sizes are taken from the same objects
+    overloaded collide_static{
+        [](const circle& a, const circle& b) { return a.size + b.size; },
+        [](const circle& a, const square& b) { return a.size * b.size; },
+    };
+    run("same", "static overloaded", n, repeat, [&collide_static, &same] {
+        double s = 0;
+        for (auto [a, b]: same)
+            s += collide_static(static_cast<const circle&>(*a),
+                                static_cast<const square&>(*b));
+        return s;
+    });
+    run_dynamic("same", collide, same, repeat);
+    run_dynamic("mixed", collide, mixed, repeat);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,117 @@
+#pragma once
+
+/* A set of overloaded functions of two arguments, extensible at run time
+ *
+ * runtime_overloaded<R, Base> is the run time counterpart of overloaded from
+ * overloaded.hpp, selecting a handler by the dynamic types of both arguments
+ * (double dispatch). add<A, B>(f) registers f(const A&, const B&) for classes
+ * A and B derived from Base non-virtually. Calling f(a, b) looks up the
+ * handler in a hash table keyed by the pair of std::type_index of a and b.
+ * Calling f(cache, a, b) checks the cache first. A cache remembers the last
+ * resolved handler and is meant to be a static thread_local variable at a
+ * call site:
+ *
+ *     static thread_local runtime_overloaded<R, Base>::cache c;
+ *     r = f(c, a, b);
+ *
+ * Each add() invalidates all caches of the set. If no handler is registered
+ * for the types, the fallback passed to the constructor is called. An empty
+ * fallback throws std::bad_function_call. add() must not run concurrently
+ * with calls.
+ *
+ * Compile with C++17 or higher
+ */
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <type_traits>
+#include <typeindex>
+#include <typeinfo>
+#include <unordered_map>
+#include <utility>
+
+// A new value on each call, shared by all sets, so that a cache never matches
+// a set other than the one that filled it
+inline uint64_t runtime_overloaded_generation()
+{
+    static std::atomic<uint64_t> next{1};
+    return next.fetch_add(1, std::memory_order_relaxed);
+}
+
+template <class R, class Base> class runtime_overloaded {
+public:
+    using handler = std::function<R(const Base&, const Base&)>;
+    class cache {
+    public:
+        cache() = default;
+    private:
+        friend runtime_overloaded;
+        const std::type_info* first = nullptr;
+        const std::type_info* second = nullptr;
+        const handler* h = nullptr;
+        uint64_t generation = 0;
+    };
+    explicit runtime_overloaded(handler fallback = {}):
+        fallback(std::move(fallback)) {}
+    // Copies get a new generation, because cached handlers point into the
+    // source, and so does the source of a move
+    runtime_overloaded(const runtime_overloaded& o):
+        handlers(o.handlers), fallback(o.fallback) {}
+    runtime_overloaded(runtime_overloaded&& o):
+        handlers(std::move(o.handlers)), fallback(std::move(o.fallback))
+    {
+        o.generation = runtime_overloaded_generation();
+    }
+    runtime_overloaded& operator=(runtime_overloaded o) {
+        handlers.swap(o.handlers);
+        fallback.swap(o.fallback);
+        generation = runtime_overloaded_generation();
+        return *this;
+    }
+    template <class A, class B, class F> runtime_overloaded& add(F f) {
+        static_assert(std::is_base_of_v<Base, A> && std::is_base_of_v<Base, B>,
+                      "handler arguments must be derived from Base");
+        handlers.insert_or_assign(key{typeid(A), typeid(B)},
+            [f = std::move(f)](const Base& a, const Base& b) -> R {
+                return f(static_cast<const A&>(a), static_cast<const B&>(b));
+            });
+        generation = runtime_overloaded_generation();
+        return *this;
+    }
+    // The handler for the dynamic types ta and tb, or the fallback
+    const handler& find(const std::type_info& ta,
+                        const std::type_info& tb) const {
+        auto it = handlers.find(key{ta, tb});
+        return it == handlers.end() ? fallback : it->second;
+    }
+    R operator()(const Base& a, const Base& b) const {
+        return find(typeid(a), typeid(b))(a, b);
+    }
+    // Type info objects are compared by address. If a type has several of
+    // them, e.g., in different shared libraries, a miss only costs a lookup.
+    R operator()(cache& c, const Base& a, const Base& b) const {
+        const std::type_info& ta = typeid(a);
+        const std::type_info& tb = typeid(b);
+        if (c.generation != generation || c.first != &ta || c.second != &tb) {
+            c.h = &find(ta, tb);
+            c.first = &ta;
+            c.second = &tb;
+            c.generation = generation;
+        }
+        return (*c.h)(a, b);
+    }
+private:
+    using key = std::pair<std::type_index, std::type_index>;
+    struct key_hash {
+        size_t operator()(const key& k) const noexcept {
+            size_t h = k.first.hash_code();
+            return h ^ (k.second.hash_code() + 0x9e3779b97f4a7c15 + (h << 6) +
+                        (h >> 2));
+        }
+    };
+    std::unordered_map<key, handler, key_hash> handlers;
+    handler fallback;
+    uint64_t generation = runtime_overloaded_generation();
+};
@@ -0,0 +1,158 @@
+/* Writing records to a file and reading them back by serial::writer and
+ * serial::reader over a serial::mapped_file compared to text iostreams,
+ * which the visitors in tuple_for.cpp and tuple_for_20.cpp use
+ *
+ * Usage: serialize [records [directory]]
+ *
+ * Compile with C++20 or higher on a POSIX system
+ */
+
+#include "bench.hpp"
+#include "serialize.hpp"
+#include "tuple_for.hpp"
+
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <vector>
+
+struct point {
+    double x, y, z;
+    int id;
+};
+
+std::ostream& operator<<(std::ostream& os, const point& p)
+{
+    return os << p.x << ' ' << p.y << ' ' << p.z << ' ' << p.id;
+}
+
+std::istream& operator>>(std::istream& is, point& p)
+{
+    return is >> p.x >> p.y >> p.z >> p.id;
+}
+
+using record = std::tuple<long, double, std::string, std::vector<float>,
+                          point>;
+
+record make_record(size_t i)
+{
+    double d = double(i) / 3;
+    return {long(i), d, std::string(4 + i % 32, char('a' + i % 26)),
+            std::vector<float>(i % 16, float(d)), point{d, d, d, int(i)}};
+}
+
+// Writes a record as text, like the display visitor in tuple_for.cpp
+struct text_out {
+    template <class T> void operator()(const T& v) {
+        os << v << ' ';
+    }
+    template <class T> void operator()(const std::vector<T>& v) {
+        os << v.size() << ' ';
+        for (auto& e: v)
+            os << e << ' ';
+    }
+    std::ostream& os;
+};
+
+struct text_in {
+    template <class T> void operator()(T& v) {
+        is >> v;
+    }
+    template <class T> void operator()(std::vector<T>& v) {
+        size_t n;
+        is >> n;
+        v.resize(n);
+        for (auto& e: v)
+            is >> e;
+    }
+    std::istream& is;
+};
+
+void display(std::string_view method, std::string_view op, size_t n,
+             size_t bytes, double ns, double sum)
+{
+    std::cout << std::setw(8) << method << std::setw(6) << op <<
+        " bytes=" << std::setw(10) << bytes << std::fixed <<
+        std::setprecision(3) << " GB/s=" << bytes / ns <<
+        std::setprecision(2) << " Mrecords/s=" << 1e3 * n / ns <<
+        std::defaultfloat << " sum=" << sum << std::endl;
+}
+
+// A checksum touching every part of a record or its view
+template <class R> double checksum(const R& r)
+{
+    double s = std::get<0>(r) + std::get<1>(r) + std::get<2>(r).size() +
+        std::get<4>(r).z;
+    for (float f: std::get<3>(r))
+        s += f;
+    return s;
+}
+
+int main(int argc, char* argv[])
+{
+    size_t n = 1'000'000;
+    std::filesystem::path dir = std::filesystem::temp_directory_path();
+    if (argc > 1)
+        n = std::stoull(argv[1]);
+    if (argc > 2)
+        dir = argv[2];
+    std::vector<record> records;
+    records.reserve(n);
+    for (size_t i = 0; i < n; ++i)
+        records.push_back(make_record(i));
+    std::string bin_path = dir / "serialize.bin";
+    std::string txt_path = dir / "serialize.txt";
+    {
+        auto start = bench::clock::now();
+        serial::writer w(bin_path);
+        for (auto& r: records)
+            w << r;
+        w.flush();
+        double ns = bench::ns_since(start);
+        display("binary", "write", n, w.size(), ns, 0);
+    }
+    {
+        auto start = bench::clock::now();
+        serial::mapped_file f(bin_path);
+        serial::reader r(f.data());
+        double sum = 0;
+        size_t count = 0;
+        for (; !r.empty(); ++count)
+            sum += checksum(r.read<record>());
+        double ns = bench::ns_since(start);
+        display("binary", "read", count, f.data().size(), ns, sum);
+    }
+    {
+        auto start = bench::clock::now();
+        std::ofstream os(txt_path);
+        os << std::setprecision(std::numeric_limits<double>::max_digits10);
+        for (auto& r: records) {
+            tuple_for(text_out{os}, r);
+            os << '\n';
+        }
+        os.close();
+        double ns = bench::ns_since(start);
+        display("iostream", "write", n, std::filesystem::file_size(txt_path),
+                ns, 0);
+    }
+    {
+        auto start = bench::clock::now();
+        std::ifstream is(txt_path);
+        double sum = 0;
+        size_t count = 0;
+        for (record r; tuple_for(text_in{is}, r), is; ++count)
+            sum += checksum(r);
+        double ns = bench::ns_since(start);
+        display("iostream", "read", count, std::filesystem::file_size(txt_path),
+                ns, sum);
+    }
+    std::filesystem::remove(bin_path);
+    std::filesystem::remove(txt_path);
+    return EXIT_SUCCESS;
+}
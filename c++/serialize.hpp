@@ -0,0 +1,330 @@
+#pragma once
+
+/* Binary serialization of values, strings, vectors, and tuples
+ *
+ * serial::writer appends values to a byte buffer, which it can write to a file
+ * in large blocks:
+ * - a trivially copyable value (a number, a struct) by a single memcpy
+ * - a std::string as a 64-bit length followed by the characters
+ * - a std::vector as a 64-bit length followed by the elements; elements of
+ *   a trivially copyable type are padded to their alignment and copied by
+ *   a single memcpy
+ * - a std::tuple or std::pair element by element, using tuple_for
+ *
+ * serial::reader reads the values back from a byte buffer, usually
+ * a serial::mapped_file, without copying strings and vectors. read<T>()
+ * returns view_t<T>: a copy of a trivially copyable value, a std::string_view
+ * for a string, a std::span pointing into the buffer for a vector of
+ * trivially copyable elements, and a tuple of views for a tuple. The buffer
+ * must be aligned to alignof(std::max_align_t) and must outlive the views.
+ *
+ * Pointers are rejected, but pointer members of a trivially copyable struct
+ * cannot be detected. They are written as addresses, which are meaningless
+ * when read back, so such structs must not be serialized.
+ *
+ * Compile with C++20 or higher on a POSIX system
+ */
+
+#include "tuple_for.hpp"
+
+#include <array>
+#include <bit>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace serial {
+
+using size_type = std::uint64_t;
+
+template <class T> struct is_vector: std::false_type {};
+template <class T, class A>
+struct is_vector<std::vector<T, A>>: std::true_type {};
+
+template <class T> struct is_tuple: std::false_type {};
+template <class ...T> struct is_tuple<std::tuple<T...>>: std::true_type {};
+template <class T1, class T2>
+struct is_tuple<std::pair<T1, T2>>: std::true_type {};
+
+template <class T> constexpr bool is_trivial_v =
+    std::is_trivially_copyable_v<T> && !std::is_pointer_v<T>;
+
+template <class T, class = void> struct view {
+    static_assert(sizeof(T) == 0, "type is not serializable");
+};
+template <class T>
+struct view<T, std::enable_if_t<is_trivial_v<T>>> {
+    using type = T;
+};
+template <> struct view<std::string> {
+    using type = std::string_view;
+};
+template <class T, class A> struct view<std::vector<T, A>> {
+    using type = std::conditional_t<is_trivial_v<T>, std::span<const T>,
+                                    std::vector<typename view<T>::type>>;
+};
+template <class ...T> struct view<std::tuple<T...>,
+                                  std::enable_if_t<!is_trivial_v<
+                                      std::tuple<T...>>>>
+{
+    using type = std::tuple<typename view<T>::type...>;
+};
+template <class T1, class T2> struct view<std::pair<T1, T2>,
+                                          std::enable_if_t<!is_trivial_v<
+                                              std::pair<T1, T2>>>>
+{
+    using type = std::pair<typename view<T1>::type, typename view<T2>::type>;
+};
+
+// The type returned by reader::read<T>()
+template <class T> using view_t = typename view<T>::type;
+
+// Writes to a buffer in memory, or to a file in blocks of block_size bytes
+class writer {
+public:
+    writer() = default;
+    // Throws std::system_error if the file cannot be created
+    explicit writer(const std::string& path, size_t block_size = 1 << 20):
+        block_size(block_size)
+    {
+        // Reserved before opening, so that the descriptor does not leak if
+        // reserving throws
+        buf.reserve(block_size);
+        fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0666);
+        if (fd < 0)
+            throw std::system_error(errno, std::generic_category(),
+                                    "serial: cannot create " + path);
+    }
+    writer(const writer&) = delete;
+    writer& operator=(const writer&) = delete;
+    // Errors of writing the rest of the buffer are ignored, call flush() to
+    // detect them
+    ~writer() {
+        if (fd >= 0) {
+            try {
+                flush();
+            } catch (...) {
+            }
+            ::close(fd);
+        }
+    }
+    template <class T> writer& write(const T& v) {
+        if constexpr (is_trivial_v<T>)
+            put(&v, sizeof(v));
+        else if constexpr (std::is_same_v<T, std::string>) {
+            put_size(v.size());
+            put(v.data(), v.size());
+        } else if constexpr (is_vector<T>::value) {
+            using value_type = typename T::value_type;
+            put_size(v.size());
+            if constexpr (is_trivial_v<value_type>) {
+                align(alignof(value_type));
+                put(v.data(), v.size() * sizeof(value_type));
+            } else
+                for (auto& e: v)
+                    write(e);
+        } else if constexpr (is_tuple<T>::value)
+            tuple_for([this](const auto& e) { write(e); }, v);
+        else
+            static_assert(sizeof(T) == 0, "type is not serializable");
+        return *this;
+    }
+    template <class T> writer& operator<<(const T& v) {
+        return write(v);
+    }
+    // The bytes not written to a file yet
+    std::span<const std::byte> data() const noexcept {
+        return buf;
+    }
+    // The number of bytes written so far
+    size_t size() const noexcept {
+        return flushed + buf.size();
+    }
+    void reserve(size_t n) {
+        buf.reserve(n);
+    }
+    void clear() noexcept {
+        buf.clear();
+    }
+    // Writes the buffer to the file, throws std::system_error on failure.
+    // Does nothing for an in-memory writer.
+    void flush() {
+        if (fd < 0)
+            return;
+        for (const std::byte* p = buf.data(); p != buf.data() + buf.size();) {
+            ssize_t n = ::write(fd, p, buf.data() + buf.size() - p);
+            if (n < 0) {
+                if (errno == EINTR)
+                    continue;
+                throw std::system_error(errno, std::generic_category(),
+                                        "serial: write failed");
+            }
+            p += n;
+        }
+        flushed += buf.size();
+        buf.clear();
+    }
+    // Writes the buffer of an in-memory writer to a file, throws
+    // std::system_error on failure
+    void save(const std::string& path) const {
+        std::ofstream f(path, std::ios::binary);
+        f.write(reinterpret_cast<const char*>(buf.data()),
+                std::streamsize(buf.size()));
+        if (!f.flush())
+            throw std::system_error(errno, std::generic_category(),
+                                    "serial: cannot write " + path);
+    }
+private:
+    void put(const void* p, size_t n) {
+        auto b = static_cast<const std::byte*>(p);
+        buf.insert(buf.end(), b, b + n);
+        if (fd >= 0 && buf.size() >= block_size)
+            flush();
+    }
+    void put_size(size_t n) {
+        size_type sz = n;
+        put(&sz, sizeof(sz));
+    }
+    void align(size_t a) {
+        size_t offset = size();
+        buf.resize(buf.size() + ((offset + a - 1) & ~(a - 1)) - offset);
+    }
+    std::vector<std::byte> buf;
+    int fd = -1;
+    size_t block_size = 0;
+    size_t flushed = 0;
+};
+
+class reader {
+public:
+    explicit reader(std::span<const std::byte> data):
+        begin(data.data()), pos(data.data()), end(data.data() + data.size())
+    {
+        if (reinterpret_cast<std::uintptr_t>(begin) %
+            alignof(std::max_align_t) != 0)
+        {
+            throw std::invalid_argument("serial: misaligned buffer");
+        }
+    }
+    // Throws std::out_of_range if the buffer is too short
+    template <class T> view_t<T> read() {
+        if constexpr (is_trivial_v<T>) {
+            // By bit_cast, T need not be default constructible
+            std::array<std::byte, sizeof(T)> bytes;
+            std::memcpy(bytes.data(), take(sizeof(T)), sizeof(T));
+            return std::bit_cast<T>(bytes);
+        } else if constexpr (std::is_same_v<T, std::string>) {
+            size_t n = read<size_type>();
+            return {reinterpret_cast<const char*>(take(n)), n};
+        } else if constexpr (is_vector<T>::value) {
+            using value_type = typename T::value_type;
+            size_t n = read<size_type>();
+            if constexpr (is_trivial_v<value_type>) {
+                align(alignof(value_type));
+                if (n > size_t(end - pos) / sizeof(value_type))
+                    throw std::out_of_range("serial: unexpected end of data");
+                // The bytes were written from objects of this type, hence
+                // they can be viewed as such objects.
+                auto p = reinterpret_cast<const value_type*>(
+                    take(n * sizeof(value_type)));
+                return {p, n};
+            } else {
+                view_t<T> v;
+                v.reserve(n);
+                for (size_t i = 0; i < n; ++i)
+                    v.push_back(read<value_type>());
+                return v;
+            }
+        } else
+            return read_tuple(static_cast<T*>(nullptr));
+    }
+    size_t remaining() const noexcept {
+        return end - pos;
+    }
+    bool empty() const noexcept {
+        return pos == end;
+    }
+private:
+    // Elements of a braced initializer list are evaluated in order
+    template <class ...T> view_t<std::tuple<T...>> read_tuple(std::tuple<T...>*)
+    {
+        return {read<T>()...};
+    }
+    template <class T1, class T2>
+    view_t<std::pair<T1, T2>> read_tuple(std::pair<T1, T2>*) {
+        return {read<T1>(), read<T2>()};
+    }
+    const std::byte* take(size_t n) {
+        if (n > size_t(end - pos))
+            throw std::out_of_range("serial: unexpected end of data");
+        return std::exchange(pos, pos + n);
+    }
+    void align(size_t a) {
+        size_t offset = pos - begin;
+        take(((offset + a - 1) & ~(a - 1)) - offset);
+    }
+    const std::byte* begin;
+    const std::byte* pos;
+    const std::byte* end;
+};
+
+// A read-only memory mapping of a whole file
+class mapped_file {
+public:
+    // Throws std::system_error on failure
+    explicit mapped_file(const std::string& path) {
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0)
+            throw std::system_error(errno, std::generic_category(),
+                                    "serial: cannot open " + path);
+        struct stat st;
+        if (::fstat(fd, &st) != 0) {
+            int e = errno;
+            ::close(fd);
+            throw std::system_error(e, std::generic_category(),
+                                    "serial: cannot stat " + path);
+        }
+        sz = size_t(st.st_size);
+        if (sz > 0) {
+            void* p = ::mmap(nullptr, sz, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (p == MAP_FAILED) {
+                int e = errno;
+                ::close(fd);
+                throw std::system_error(e, std::generic_category(),
+                                        "serial: cannot map " + path);
+            }
+            addr = static_cast<const std::byte*>(p);
+        }
+        ::close(fd);
+    }
+    mapped_file(const mapped_file&) = delete;
+    mapped_file& operator=(const mapped_file&) = delete;
+    ~mapped_file() {
+        if (addr)
+            ::munmap(const_cast<std::byte*>(addr), sz);
+    }
+    std::span<const std::byte> data() const noexcept {
+        return {addr, sz};
+    }
+private:
+    const std::byte* addr = nullptr;
+    size_t sz = 0;
+};
+
+} // namespace serial
@@ -0,0 +1,211 @@
+/* Cost of reference counting when many threads copy the same pointer
+ *
+ * Each thread repeatedly copies and destroys a pointer to a single shared
+ * object. Compared are std::shared_ptr, an intrusive pointer with an atomic
+ * reference count, an intrusive pointer with a non-atomic reference count
+ * (single thread only), and a split reference count, where each thread holds
+ * one reference to the shared atomic counter and copies inside the thread
+ * change only a non-atomic thread-local counter.
+ *
+ * Usage: shared_ptr_contention [max_threads [iterations]]
+ *
+ * Compile with C++20 or higher
+ */
+
+#include "bench.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <barrier>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+inline void add_ref(std::atomic<long>& c) noexcept
+{
+    c.fetch_add(1, std::memory_order_relaxed);
+}
+
+// Returns true if the last reference has been released
+inline bool release(std::atomic<long>& c) noexcept
+{
+    return c.fetch_sub(1, std::memory_order_acq_rel) == 1;
+}
+
+inline void add_ref(long& c) noexcept
+{
+    ++c;
+}
+
+inline bool release(long& c) noexcept
+{
+    return --c == 0;
+}
+
+// Base class of objects pointed to by intrusive_ptr. C is the type of the
+// reference counter, std::atomic<long> or long.
+template <class C> class ref_counted {
+protected:
+    ref_counted() = default;
+    ref_counted(const ref_counted&) noexcept {}
+    ref_counted& operator=(const ref_counted&) noexcept { return *this; }
+    ~ref_counted() = default;
+private:
+    mutable C refs{0};
+    template <class T> friend class intrusive_ptr;
+};
+
+template <class T> class intrusive_ptr {
+public:
+    intrusive_ptr() noexcept = default;
+    explicit intrusive_ptr(T* p) noexcept: p(p) {
+        if (p)
+            add_ref(p->refs);
+    }
+    intrusive_ptr(const intrusive_ptr& o) noexcept: intrusive_ptr(o.p) {}
+    intrusive_ptr(intrusive_ptr&& o) noexcept: p(std::exchange(o.p, nullptr))
+    {}
+    ~intrusive_ptr() {
+        if (p && release(p->refs))
+            delete p;
+    }
+    intrusive_ptr& operator=(intrusive_ptr o) noexcept {
+        std::swap(p, o.p);
+        return *this;
+    }
+    T* get() const noexcept { return p; }
+    T& operator*() const noexcept { return *p; }
+    T* operator->() const noexcept { return p; }
+private:
+    T* p = nullptr;
+};
+
+template <class T, class ...A> intrusive_ptr<T> make_intrusive(A&& ...a)
+{
+    return intrusive_ptr<T>(new T(std::forward<A>(a)...));
+}
+
+// A thread-local handle to an object shared by intrusive_ptr. It holds a
+// single reference to the object and counts its own copies by a non-atomic
+// counter, hence copies must not leave the thread.
+template <class T> class local_ptr {
+public:
+    explicit local_ptr(intrusive_ptr<T> p): b(new block{std::move(p), 1}) {}
+    local_ptr(const local_ptr& o) noexcept: b(o.b) {
+        ++b->refs;
+    }
+    local_ptr& operator=(const local_ptr&) = delete;
+    ~local_ptr() {
+        if (--b->refs == 0)
+            delete b;
+    }
+    T* get() const noexcept { return b->global.get(); }
+    T& operator*() const noexcept { return *get(); }
+    T* operator->() const noexcept { return get(); }
+private:
+    struct block {
+        intrusive_ptr<T> global;
+        size_t refs;
+    };
+    block* b;
+};
+
+template <class C> struct payload: ref_counted<C> {
+    int value = 1;
+};
+
+// Each of the threads obtains a pointer p = make_local(src) to the shared
+// object and then repeatedly copies and destroys p. The threads start each
+// of the runs configured by bench::options together. Records the statistics
+// of the runs, each the average over the threads, as case name, and returns
+// the median time of a copy and destruction in nanoseconds.
+template <class P, class L>
+double run(std::string_view name, const P& src, L make_local,
+           unsigned threads, size_t iterations)
+{
+    const auto& opts = bench::options::from_env();
+    size_t runs = opts.warmup + opts.repeats;
+    std::barrier sync(threads);
+    // ns[r * threads + t] is the time per copy in run r of thread t
+    std::vector<double> ns(runs * threads);
+    std::vector<std::thread> workers;
+    for (unsigned t = 0; t < threads; ++t)
+        workers.emplace_back([&, t]() {
+            auto p = make_local(src);
+            for (size_t r = 0; r < runs; ++r) {
+                sync.arrive_and_wait();
+                auto start = bench::clock::now();
+                for (size_t i = 0; i < iterations; ++i) {
+                    auto c = p;
+                    bench::do_not_optimize(c);
+                }
+                ns[r * threads + t] = bench::ns_since(start) /
+                    double(iterations);
+            }
+        });
+    for (auto& w: workers)
+        w.join();
+    std::vector<double> samples;
+    for (size_t r = opts.warmup; r < runs; ++r) {
+        double sum = 0.0;
+        for (unsigned t = 0; t < threads; ++t)
+            sum += ns[r * threads + t];
+        samples.push_back(sum / threads);
+    }
+    bench::stats s = bench::summarize(samples, opts.outlier);
+    bench::record(std::string(name) + " threads=" + std::to_string(threads),
+                  iterations, s, opts);
+    return s.median;
+}
+
+void display(std::string_view name, unsigned threads, double ns)
+{
+    std::cout << std::setw(16) << name << " threads=" << std::setw(3) <<
+        threads << " ns/copy=" << std::fixed << std::setprecision(2) << ns <<
+        std::defaultfloat << std::endl;
+}
+
+int usage(std::string_view argv0)
+{
+    std::cerr << "usage: " << argv0 << " [max_threads [iterations]], " <<
+        "iterations must be positive" << std::endl;
+    return EXIT_FAILURE;
+}
+
+int main(int argc, char* argv[])
+{
+    unsigned max_threads = std::max(std::thread::hardware_concurrency(), 1U);
+    size_t iterations = 10'000'000;
+    if (argc > 1)
+        max_threads = std::stoul(argv[1]);
+    if (argc > 2)
+        iterations = std::stoull(argv[2]);
+    // the time of a copy is the time of a run divided by iterations
+    if (iterations == 0)
+        return usage(argv[0]);
+    auto copy = [](auto& p) { return p; };
+    auto shared = std::make_shared<payload<long>>();
+    auto intrusive = make_intrusive<payload<std::atomic<long>>>();
+    auto nonatomic = make_intrusive<payload<long>>();
+    for (unsigned threads = 1; threads <= max_threads; ++threads) {
+        display("shared_ptr", threads,
+                run("shared_ptr", shared, copy, threads, iterations));
+        display("intrusive_ptr", threads,
+                run("intrusive_ptr", intrusive, copy, threads, iterations));
+        if (threads == 1)
+            display("nonatomic_ptr", threads,
+                    run("nonatomic_ptr", nonatomic, copy, threads,
+                        iterations));
+        display("local_ptr", threads,
+                run("local_ptr", intrusive,
+                    [](auto& p) { return local_ptr(p); }, threads,
+                    iterations));
+    }
+    return EXIT_SUCCESS;
+}
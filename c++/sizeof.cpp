@@ -1,8 +1,13 @@
 /* Sizes of various C++ types
+ *
+ * Reallocations of containers are reported with the time and hardware
+ * counters per push_back from perf_counters.hpp.
  *
  * Compile with C++17 or higher
  */
 
+#include "perf_counters.hpp"
+
 #include <any>
 #include <atomic>
 #include <condition_variable>
@@ -61,6 +66,42 @@ void operator delete(void* p) noexcept
     free(p);
 }
 
+void* operator new(std::size_t sz, std::align_val_t al)
+{
+    new_called = true;
+    static bool recursive = false;
+    auto a = static_cast<std::size_t>(al);
+    // size passed to aligned_alloc() must be a multiple of alignment
+    void* p = aligned_alloc(a, (sz + a - 1) / a * a);
+    if (!recursive && new_log) {
+        recursive = true;
+        try {
+            std::cout << "new(" << sz << ", " << a << ")=" << p << std::endl;
+        } catch (...) {
+        }
+        recursive = false;
+    }
+    if (!p)
+        throw std::bad_alloc{};
+    return p;
+}
+
+// The other forms of delete must release memory by the replaced ones, too
+void operator delete(void* p, std::align_val_t) noexcept
+{
+    operator delete(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept
+{
+    operator delete(p);
+}
+
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept
+{
+    operator delete(p);
+}
+
 template <class T> void display_size(std::string_view type)
 {
     std::string_view pref{"decltype("};
@@ -76,24 +117,34 @@ template <class T> void display_size(std::string_view type)
 
 #define DISPLAY_SIZE(type) display_size<type>(#type)
 
-template <class T> void display_realloc(std::string_view type,
-                                        size_t n = 1'000'000)
+template <class T>
+void display_realloc(perf::counter_group& counters, std::string_view type,
+                     size_t n = 1'000'000)
 {
+    perf::sample s;
     T o{};
     std::cout << type << " initial capacity " << o.capacity() <<
         " reallocations at sizes:" << std::endl;
-    unsigned reallocs = 0;
-    for (size_t i = 1; i <= n; ++i) {
-        new_called = false;
-        o.push_back(typename T::value_type{});
-        if (new_called)
-            std::cout << ' ' << ++reallocs << ':' << i << "->" <<
-                o.capacity();
+    // pairs of size and new capacity, printed after the measured region,
+    // reserved for geometric growth, so that recording does not allocate
+    std::vector<std::pair<size_t, size_t>> reallocs;
+    reallocs.reserve(64);
+    {
+        perf::region r{counters, s};
+        for (size_t i = 1; i <= n; ++i) {
+            new_called = false;
+            o.push_back(typename T::value_type{});
+            if (new_called)
+                reallocs.emplace_back(i, o.capacity());
+        }
     }
-    std::cout << std::endl;
+    for (size_t i = 0; i < reallocs.size(); ++i)
+        std::cout << ' ' << i + 1 << ':' << reallocs[i].first << "->" <<
+            reallocs[i].second;
+    std::cout << std::endl << "per push_back: " << s.per(n) << std::endl;
 }
 
-#define DISPLAY_REALLOC(type) display_realloc<type>(#type)
+#define DISPLAY_REALLOC(counters, type) display_realloc<type>(counters, #type)
 
 template <template <class ...> class T>
 void display_assoc_realloc(std::string_view type, size_t n = 10)
@@ -202,12 +253,17 @@ int main(int, char*[])
     std::function<void()>{[&p1, &p2, &p3, &p4]() {
         std::cout << "ref=4" << std::endl;
     }}();
-    new_log = false;
+    new_log = delete_log = false;
     // reallocations in std containers
-    DISPLAY_REALLOC(std::string);
-    DISPLAY_REALLOC(std::u16string);
-    DISPLAY_REALLOC(std::vector<char>);
-    DISPLAY_REALLOC(std::vector<long>);
+    {
+        perf::counter_group counters;
+        if (!counters.error().empty())
+            std::cerr << "perf counters: " << counters.error() << std::endl;
+        DISPLAY_REALLOC(counters, std::string);
+        DISPLAY_REALLOC(counters, std::u16string);
+        DISPLAY_REALLOC(counters, std::vector<char>);
+        DISPLAY_REALLOC(counters, std::vector<long>);
+    }
     DISPLAY_ASSOC_REALLOC(std::map);
     DISPLAY_ASSOC_REALLOC(std::unordered_map);
 
@@ -0,0 +1,124 @@
+/* soa_vector compared to std::vector of std::tuple (an array of structures)
+ * in loops touching one or two of ten fields of each element
+ *
+ * Usage: soa_vector [elements [repeat]]
+ *
+ * Compile with C++20 or higher
+ */
+
+#include "bench.hpp"
+#include "soa_vector.hpp"
+
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <vector>
+
+using record = std::tuple<double, double, double, long, long, int, int, float,
+                          float, char>;
+
+record make_record(size_t i)
+{
+    double d = double(i % 1000);
+    return {d, d / 2, 0, long(i), long(i), int(i), int(i), float(d), float(d),
+            char(i)};
+}
+
+template <class T> struct soa_of;
+template <class ...T> struct soa_of<std::tuple<T...>> {
+    using type = soa_vector<T...>;
+};
+
+void display(std::string_view container, std::string_view op, size_t n,
+             double ns, double sum)
+{
+    std::cout << std::setw(14) << container << std::setw(16) << op <<
+        std::fixed << std::setprecision(3) << " ns/element=" << ns / n <<
+        std::defaultfloat << " sum=" << sum << std::endl;
+}
+
+int main(int argc, char* argv[])
+{
+    size_t n = 4'000'000;
+    size_t repeat = 10;
+    if (argc > 1)
+        n = std::stoull(argv[1]);
+    if (argc > 2)
+        repeat = std::stoull(argv[2]);
+    std::vector<record> aos;
+    soa_of<record>::type soa;
+    aos.reserve(n);
+    soa.reserve(n);
+    for (size_t i = 0; i < n; ++i) {
+        aos.push_back(make_record(i));
+        soa.push_back(make_record(i));
+    }
+    double sum = 0;
+    double ns = bench::ns_per_op("vector<tuple> scan", repeat,
+                                 [&aos, &sum](size_t) {
+        double s = 0;
+        for (auto& r: aos)
+            s += std::get<0>(r);
+        sum = s;
+        bench::do_not_optimize(sum);
+    });
+    display("vector<tuple>", "scan", n, ns, sum);
+    ns = bench::ns_per_op("soa_vector scan column", repeat,
+                          [&soa, &sum](size_t) {
+        double s = 0;
+        for (double d: soa.column<0>())
+            s += d;
+        sum = s;
+        bench::do_not_optimize(sum);
+    });
+    display("soa_vector", "scan column", n, ns, sum);
+    ns = bench::ns_per_op("vector<tuple> update", repeat, [&aos](size_t) {
+        for (auto& r: aos)
+            std::get<2>(r) += std::get<0>(r) * std::get<1>(r);
+        bench::clobber();
+    });
+    display("vector<tuple>", "update", n, ns, std::get<2>(aos[n - 1]));
+    ns = bench::ns_per_op("soa_vector update columns", repeat, [&soa](size_t) {
+        auto a = soa.column<0>();
+        auto b = soa.column<1>();
+        auto c = soa.column<2>();
+        for (size_t i = 0; i < c.size(); ++i)
+            c[i] += a[i] * b[i];
+        bench::clobber();
+    });
+    display("soa_vector", "update columns", n, ns, soa[n - 1].get<2>());
+    ns = bench::ns_per_op("soa_vector update rows", repeat, [&soa](size_t) {
+        for (size_t i = 0; i < soa.size(); ++i) {
+            auto r = soa[i];
+            get<2>(r) += get<0>(r) * get<1>(r);
+        }
+        bench::clobber();
+    });
+    display("soa_vector", "update rows", n, ns, soa[n - 1].get<2>());
+    ns = bench::ns_per_op("vector<tuple> copy rows", repeat,
+                          [&aos, &sum](size_t) {
+        double s = 0;
+        for (auto& r: aos) {
+            record c = r;
+            s += std::get<2>(c);
+        }
+        sum = s;
+        bench::do_not_optimize(sum);
+    });
+    display("vector<tuple>", "copy rows", n, ns, sum);
+    ns = bench::ns_per_op("soa_vector copy rows", repeat,
+                          [&soa, &sum](size_t) {
+        double s = 0;
+        for (size_t i = 0; i < soa.size(); ++i) {
+            record c = soa[i];
+            s += std::get<2>(c);
+        }
+        sum = s;
+        bench::do_not_optimize(sum);
+    });
+    display("soa_vector", "copy rows", n, ns, sum);
+    return EXIT_SUCCESS;
+}
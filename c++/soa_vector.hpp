@@ -0,0 +1,132 @@
+#pragma once
+
+/* A structure of arrays: a container of tuples std::tuple<T...>, which stores
+ * each element of the tuples in a separate contiguous column
+ *
+ * A loop over one or two columns touches only memory of these columns, and
+ * the columns can be accessed as std::span, suitable for auto-vectorization.
+ * Rows are accessed via proxy objects.
+ *
+ * Compile with C++20 or higher
+ */
+
+#include "tuple_for.hpp"
+
+#include <cstddef>
+#include <span>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+template <class ...T> class soa_vector {
+public:
+    using value_type = std::tuple<T...>;
+    template <size_t I>
+    using element_type = std::tuple_element_t<I, value_type>;
+    // A reference to a row, Const selects const or mutable access
+    template <bool Const> class row_ref {
+    public:
+        using container_type =
+            std::conditional_t<Const, const soa_vector, soa_vector>;
+        row_ref(container_type& c, size_t i) noexcept: c(&c), i(i) {}
+        template <size_t I> decltype(auto) get() const noexcept {
+            return std::get<I>(c->columns)[i];
+        }
+        operator value_type() const {
+            return get_all(std::index_sequence_for<T...>{});
+        }
+        const row_ref& operator=(const value_type& v) const requires (!Const)
+        {
+            set_all(v, std::index_sequence_for<T...>{});
+            return *this;
+        }
+        size_t index() const noexcept {
+            return i;
+        }
+        // get<I>(row), found by argument dependent lookup
+        template <size_t I> friend decltype(auto) get(const row_ref& r) noexcept
+        {
+            return r.template get<I>();
+        }
+    private:
+        template <size_t ...I>
+        value_type get_all(std::index_sequence<I...>) const {
+            return {get<I>()...};
+        }
+        template <size_t ...I>
+        void set_all(const value_type& v, std::index_sequence<I...>) const {
+            (..., (get<I>() = std::get<I>(v)));
+        }
+        container_type* c;
+        size_t i;
+    };
+    using reference = row_ref<false>;
+    using const_reference = row_ref<true>;
+    size_t size() const noexcept {
+        return std::get<0>(columns).size();
+    }
+    bool empty() const noexcept {
+        return size() == 0;
+    }
+    void reserve(size_t n) {
+        tuple_for([n](auto& c) { c.reserve(n); }, columns);
+    }
+    void clear() noexcept {
+        tuple_for([](auto& c) { c.clear(); }, columns);
+    }
+    void pop_back() {
+        tuple_for([](auto& c) { c.pop_back(); }, columns);
+    }
+    void push_back(const value_type& v) {
+        emplace_back_impl(v, std::index_sequence_for<T...>{});
+    }
+    void push_back(value_type&& v) {
+        emplace_back_impl(std::move(v), std::index_sequence_for<T...>{});
+    }
+    template <class ...A> void emplace_back(A&& ...a) {
+        emplace_back_impl(std::forward_as_tuple(std::forward<A>(a)...),
+                          std::index_sequence_for<T...>{});
+    }
+    reference operator[](size_t i) noexcept {
+        return {*this, i};
+    }
+    const_reference operator[](size_t i) const noexcept {
+        return {*this, i};
+    }
+    template <size_t I> std::span<element_type<I>> column() noexcept {
+        return std::get<I>(columns);
+    }
+    template <size_t I>
+    std::span<const element_type<I>> column() const noexcept {
+        return std::get<I>(columns);
+    }
+private:
+    // If adding to a column fails, the elements already added to other
+    // columns are removed. Capacity of all columns is ensured first, so that
+    // only constructing an element can fail after the first column has taken
+    // its value. This gives the strong exception guarantee for lvalues, and
+    // for rvalues if constructing every column from them is nothrow, e.g.,
+    // moving types with a nothrow move constructor. Otherwise, only the basic
+    // guarantee holds, because values moved from v to earlier columns are
+    // lost.
+    template <class V, size_t ...I>
+    void emplace_back_impl(V&& v, std::index_sequence<I...>) {
+        size_t n = size();
+        tuple_for([n](auto& c) {
+            if (c.capacity() == n)
+                c.reserve(n == 0 ? 1 : 2 * n);
+        }, columns);
+        try {
+            (..., std::get<I>(columns).emplace_back(
+                std::get<I>(std::forward<V>(v))));
+        } catch (...) {
+            tuple_for([n](auto& c) {
+                if (c.size() > n)
+                    c.pop_back();
+            }, columns);
+            throw;
+        }
+    }
+    std::tuple<std::vector<T>...> columns;
+};
@@ -1,16 +1,27 @@
 /* Features of std::any
  *
- * Compile with C++17 or higher
+ * The cost of creating and destroying std::any and basic_any objects is
+ * reported with the time and hardware counters per object from
+ * perf_counters.hpp.
+ *
+ * Compile with C++20 or higher, together with new_delete.cpp
  */
 
+#include "any_visitor.hpp"
+#include "basic_any.hpp"
+#include "bench.hpp"
 #include "new_delete.hpp"
 #include "log_constr_destr_assign.hpp"
+#include "perf_counters.hpp"
+#include "type_grouped.hpp"
 
 #include <algorithm>
 #include <any>
 #include <array>
+#include <functional>
 #include <iostream>
 #include <memory>
+#include <string_view>
 #include <type_traits>
 #include <typeindex>
 #include <typeinfo>
@@ -54,21 +65,6 @@ std::ostream& operator<<(std::ostream& o, const data_big& v)
     return o << v.a.size() << "x" << v.a[0];
 }
 
-template <class T, class F>
-std::pair<const std::type_index, std::function<void(const std::any&)>>
-make_any_visitor(const F& f)
-{
-    return {
-        std::type_index(typeid(T)),
-        [f](const std::any & a) {
-            if constexpr (std::is_void_v<T>)
-                f(a);
-            else
-                f(a, std::any_cast<const T&>(a));
-        }
-    };
-}
-
 void display_any_obj(const char* t, const std::any& a)
 {
     std::cout << "any<" << t << ">=" << & a << " sizeof=" << sizeof(a) <<
@@ -92,8 +88,7 @@ void display_val(const char* t, const std::any& a, const T& v)
     make_any_visitor<t>( \
         [](const auto& a, const auto& v) { display_val(#t, a, v); })
 
-std::unordered_map<std::type_index, std::function<void(const std::any&)>>
-display_visitors{
+any_visitor_map display_visitors{
     make_any_visitor<void>([](auto&& a){ display_val("void", a); }),
     MAKE_DISPLAY_VISITOR(empty),
 };
@@ -110,20 +105,51 @@ void display(const std::any& a)
     }
 }
 
-template <size_t S> bool create_any()
+template <class Any, size_t S> bool create_any()
 {
     new_delete::new_called = false;
-    (void)std::any(std::array<char, S>{});
+    {
+        // prevent eliding a new-expression and a matching delete-expression
+        Any a(std::array<char, S>{});
+        bench::do_not_optimize(a);
+    }
     return new_delete::new_called;
 }
 
-template <size_t ...I> size_t check_any_alloc(std::index_sequence<I...>)
+template <class Any, size_t ...I>
+size_t check_any_alloc(std::index_sequence<I...>)
 {
     size_t min_alloc = 0;
-    (void)(... && (create_any<I>() ? (min_alloc = I, false) : true));
+    (void)(... && (create_any<Any, I>() ? (min_alloc = I, false) : true));
     return min_alloc;
 }
 
+#define CHECK_ANY_ALLOC(type) \
+    std::cout << "minimum size of separate allocation in " #type "=" << \
+        check_any_alloc<type>(std::make_index_sequence<128>{}) << std::endl
+
+// Creates and destroys n objects of type Any holding a value of type T
+template <class Any, class T>
+void measure_any(perf::counter_group& counters, std::string_view name,
+                 size_t n)
+{
+    perf::sample s;
+    {
+        perf::region r{counters, s};
+        for (size_t i = 0; i < n; ++i) {
+            Any a(T{});
+            bench::do_not_optimize(a);
+        }
+    }
+    std::cout << name << ": " << s.per(n) << std::endl;
+}
+
+#define MEASURE_ANY(counters, any, type) \
+    measure_any<any, type>(counters, #any " " #type, 1'000'000)
+
+using small_value = std::array<char, 8>;
+using medium_value = std::array<char, 48>;
+
 int main() {
     new_delete::new_log = true;
     new_delete::delete_log = true;
@@ -143,10 +169,63 @@ int main() {
     display(data);
     std::cout << "--- end" << std::endl;
     data.reset();
+    std::cout << "--- basic_any big" << std::endl;
+    {
+        basic_any<sizeof(data_big)> big = data_big(5);
+        std::cout << "value=" << any_cast<const data_big&>(big) << std::endl;
+    }
+    std::cout << "--- cow_any big copy" << std::endl;
+    {
+        cow_any<> big = data_big(6);
+        auto copy = big;
+        std::cout << "shared=" << (any_cast<const data_big>(&big) ==
+                                   any_cast<const data_big>(&copy)) <<
+            std::endl;
+        std::cout << "--- cow_any big write" << std::endl;
+        any_cast<data_big&>(copy).a[0] = 7;
+        std::cout << "value=" << any_cast<const data_big&>(big) <<
+            " copy=" << any_cast<const data_big&>(copy) << std::endl;
+    }
+    std::cout << "--- type_grouped" << std::endl;
+    {
+        type_grouped<empty, data_int, data_big> g;
+        g.push_back(data_int{1});
+        g.push_back(empty{});
+        g.push_back(data_int{2});
+        g.push_back(data_big(3));
+        std::cout << "--- type_grouped visit" << std::endl;
+        auto display_group = [](const char* t) {
+            return [t](size_t i, const auto& v) {
+                std::cout << t << '[' << i << "]=" << v << " @" << &v <<
+                    std::endl;
+            };
+        };
+        g.visit(make_group_visitor<empty>(display_group("empty")),
+                make_group_visitor<data_int>(display_group("data_int")),
+                make_group_visitor<data_big>(display_group("data_big")));
+        std::cout << "--- type_grouped in order" << std::endl;
+        g.visit_in_order([](size_t i, const auto& v) {
+            std::cout << '[' << i << "]=" << v << std::endl;
+        });
+    }
     std::cout << "--- check alloc" << std::endl;
     new_delete::new_log = false;
     new_delete::delete_log = false;
-    std::cout << "minimum size of separate allocation=" <<
-        check_any_alloc(std::make_index_sequence<128>{}) << std::endl;
+    CHECK_ANY_ALLOC(std::any);
+    CHECK_ANY_ALLOC(basic_any<>);
+    CHECK_ANY_ALLOC(basic_any<32>);
+    CHECK_ANY_ALLOC(basic_any<64>);
+    CHECK_ANY_ALLOC(move_only_any<64>);
+    CHECK_ANY_ALLOC(cow_any<64>);
+    std::cout << "--- storage cost per object" << std::endl;
+    perf::counter_group counters;
+    if (!counters.error().empty())
+        std::cerr << "perf counters: " << counters.error() << std::endl;
+    MEASURE_ANY(counters, std::any, small_value);
+    MEASURE_ANY(counters, std::any, medium_value);
+    MEASURE_ANY(counters, basic_any<>, small_value);
+    MEASURE_ANY(counters, basic_any<>, medium_value);
+    MEASURE_ANY(counters, basic_any<64>, medium_value);
+    MEASURE_ANY(counters, cow_any<64>, medium_value);
     return 0;
 }
@@ -0,0 +1,242 @@
+/* Layout of aggregates: offsets, alignment, and padding of members, members
+ * crossing cache lines, and a member order with minimal size. Limits of a
+ * layout can be checked at compile time by static_assert.
+ *
+ * Members are listed explicitly by LAYOUT_MEMBER, because offsets cannot be
+ * obtained from structured bindings. The structured binding (aggregate
+ * initialization) trick is used to count members of an aggregate, so that a
+ * member missing in the list is detected.
+ *
+ * Compile with C++20 or higher
+ */
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+inline constexpr size_t cache_line = 64;
+
+struct member_info {
+    std::string_view name;
+    size_t offset;
+    size_t size;
+    size_t align;
+};
+
+#define LAYOUT_MEMBER(t, m) \
+    member_info{#m, offsetof(t, m), sizeof(t::m), alignof(decltype(t::m))}
+
+// Specialize for each analyzed type, with a member
+// static constexpr std::array<member_info, N> list
+template <class T> struct layout_members;
+
+// Convertible to the type of any member, used only in unevaluated context
+struct any_init {
+    template <class T> constexpr operator T() const noexcept;
+};
+
+// Number of members of an aggregate. It is the maximum number of initializers
+// accepted by aggregate initialization. A C array member is counted as its
+// number of elements, because of brace elision, so use std::array instead.
+template <class T, class ...A> constexpr size_t member_count()
+{
+    if constexpr (requires { T{A{}..., any_init{}}; })
+        return member_count<T, A..., any_init>();
+    else
+        return sizeof...(A);
+}
+
+constexpr size_t align_up(size_t v, size_t align)
+{
+    return (v + align - 1) / align * align;
+}
+
+template <class T> struct layout_of {
+    static constexpr auto& list = layout_members<T>::list;
+    static constexpr size_t n = list.size();
+    static_assert(!std::is_aggregate_v<T> || member_count<T>() == n,
+                  "layout_members does not list all members");
+    static constexpr size_t size = sizeof(T);
+    static constexpr size_t align = alignof(T);
+    // members ordered by offset
+    static constexpr std::array<member_info, n> members = []{
+        auto m = list;
+        std::sort(m.begin(), m.end(),
+                  [](auto& a, auto& b) { return a.offset < b.offset; });
+        return m;
+    }();
+    // padding before each member, the last element is the tail padding
+    static constexpr std::array<size_t, n + 1> padding_before = []{
+        std::array<size_t, n + 1> p{};
+        size_t end = 0;
+        for (size_t i = 0; i < n; ++i) {
+            p[i] = members[i].offset - end;
+            end = members[i].offset + members[i].size;
+        }
+        p[n] = size - end;
+        return p;
+    }();
+    static constexpr size_t padding = []{
+        size_t s = 0;
+        for (auto p: padding_before)
+            s += p;
+        return s;
+    }();
+    static constexpr bool crosses_cache_line(const member_info& m) {
+        return m.size > 0 &&
+            m.offset / cache_line != (m.offset + m.size - 1) / cache_line;
+    }
+    static constexpr size_t cache_line_crossings = []{
+        size_t c = 0;
+        for (auto& m: members)
+            if (crosses_cache_line(m))
+                ++c;
+        return c;
+    }();
+    // Sorting by decreasing alignment needs padding only at the end, because
+    // alignments are powers of 2 and each size is a multiple of its alignment
+    static constexpr std::array<member_info, n> suggested = []{
+        auto m = members;
+        // std::stable_sort is not constexpr, keep the order by offset
+        std::sort(m.begin(), m.end(), [](auto& a, auto& b) {
+            return a.align > b.align ||
+                (a.align == b.align && a.offset < b.offset);
+        });
+        size_t off = 0;
+        for (auto& v: m) {
+            v.offset = align_up(off, v.align);
+            off = v.offset + v.size;
+        }
+        return m;
+    }();
+    static constexpr size_t suggested_size = []{
+        if constexpr (n == 0)
+            return size;
+        else
+            return align_up(suggested[n - 1].offset + suggested[n - 1].size,
+                            align);
+    }();
+};
+
+// Limits checked by within_budget, unspecified limits are not checked
+struct budget {
+    size_t size = SIZE_MAX;
+    size_t padding = SIZE_MAX;
+    size_t cache_line_crossings = SIZE_MAX;
+    size_t wasted = SIZE_MAX; // difference from the suggested order
+};
+
+template <class T> constexpr bool within_budget(budget b)
+{
+    using l = layout_of<T>;
+    return l::size <= b.size && l::padding <= b.padding &&
+        l::cache_line_crossings <= b.cache_line_crossings &&
+        l::size - l::suggested_size <= b.wasted;
+}
+
+template <class T> void display_layout(std::string_view type)
+{
+    using l = layout_of<T>;
+    std::cout << type << " sizeof=" << l::size << " alignof=" << l::align <<
+        " padding=" << l::padding << " cache_line_crossings=" <<
+        l::cache_line_crossings << std::endl;
+    for (size_t i = 0; i < l::n; ++i) {
+        auto& m = l::members[i];
+        if (l::padding_before[i] > 0)
+            std::cout << "    (padding " << l::padding_before[i] << ")" <<
+                std::endl;
+        std::cout << "    " << std::setw(4) << m.offset << ' ' << m.name <<
+            " size=" << m.size << " align=" << m.align;
+        if (l::crosses_cache_line(m))
+            std::cout << " crosses cache line";
+        std::cout << std::endl;
+    }
+    if (l::padding_before[l::n] > 0)
+        std::cout << "    (tail padding " << l::padding_before[l::n] << ")" <<
+            std::endl;
+    std::cout << "  suggested order sizeof=" << l::suggested_size << ":";
+    for (auto& m: l::suggested)
+        std::cout << ' ' << m.name;
+    std::cout << std::endl;
+}
+
+#define DISPLAY_LAYOUT(type) display_layout<type>(#type)
+
+struct hot {
+    char a;
+    double b;
+    char c;
+    int d;
+    bool e;
+    long f;
+};
+
+template <> struct layout_members<hot> {
+    static constexpr std::array list{
+        LAYOUT_MEMBER(hot, a),
+        LAYOUT_MEMBER(hot, b),
+        LAYOUT_MEMBER(hot, c),
+        LAYOUT_MEMBER(hot, d),
+        LAYOUT_MEMBER(hot, e),
+        LAYOUT_MEMBER(hot, f),
+    };
+};
+
+struct hot_sorted {
+    double b;
+    long f;
+    int d;
+    char a;
+    char c;
+    bool e;
+};
+
+template <> struct layout_members<hot_sorted> {
+    static constexpr std::array list{
+        LAYOUT_MEMBER(hot_sorted, b),
+        LAYOUT_MEMBER(hot_sorted, f),
+        LAYOUT_MEMBER(hot_sorted, d),
+        LAYOUT_MEMBER(hot_sorted, a),
+        LAYOUT_MEMBER(hot_sorted, c),
+        LAYOUT_MEMBER(hot_sorted, e),
+    };
+};
+
+struct header {
+    uint32_t id;
+    std::array<char, 62> name;
+    uint64_t key;
+    std::string value;
+};
+
+template <> struct layout_members<header> {
+    static constexpr std::array list{
+        LAYOUT_MEMBER(header, id),
+        LAYOUT_MEMBER(header, name),
+        LAYOUT_MEMBER(header, key),
+        LAYOUT_MEMBER(header, value),
+    };
+};
+
+static_assert(member_count<hot>() == 6);
+static_assert(member_count<header>() == 4);
+static_assert(layout_of<hot>::suggested_size == sizeof(hot_sorted));
+static_assert(within_budget<hot_sorted>({.size = 24, .wasted = 0}));
+static_assert(!within_budget<hot>({.padding = 8}));
+// Uncomment to see how a budget violation fails the build
+//static_assert(within_budget<header>({.cache_line_crossings = 0}));
+
+int main()
+{
+    DISPLAY_LAYOUT(hot);
+    DISPLAY_LAYOUT(hot_sorted);
+    DISPLAY_LAYOUT(header);
+    return 0;
+}
@@ -0,0 +1,81 @@
+/* Four subsystems, each in its own thread, allocating and freeing list nodes
+ * by pool_allocator from tag_pool.hpp, with one pool shared by all of them,
+ * and with a separate pool for each, compared to std::allocator
+ *
+ * Usage: tag_pool [nodes_per_thread]
+ *
+ * Compile with C++20 or higher
+ */
+
+#include "bench.hpp"
+#include "tag_pool.hpp"
+#include "unique_type.hpp"
+
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <list>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+using shared_pool = unique<pool_tag>;
+using parser_pool = unique<pool_tag>;
+using network_pool = unique<pool_tag>;
+using render_pool = unique<pool_tag>;
+using audio_pool = unique<pool_tag>;
+
+constexpr size_t batch = 64;
+
+// Builds and destroys lists of batch nodes until n nodes are allocated
+template <class Alloc> void churn(size_t n)
+{
+    std::list<long, Alloc> l;
+    for (size_t i = 0; i < n; i += batch) {
+        for (size_t j = 0; j < batch; ++j)
+            l.push_back(long(i + j));
+        bench::do_not_optimize(l);
+        l.clear();
+    }
+}
+
+template <class ...Alloc> void run(std::string_view method, size_t n)
+{
+    auto start = bench::clock::now();
+    std::vector<std::thread> threads;
+    (..., threads.emplace_back(churn<Alloc>, n));
+    for (auto& t: threads)
+        t.join();
+    double ns = bench::ns_since(start) / double(n * sizeof...(Alloc));
+    std::cout << std::setw(18) << method << std::fixed <<
+        std::setprecision(2) << " ns/node=" << ns << std::defaultfloat <<
+        std::endl;
+}
+
+template <class Tag> void display_stats(std::string_view name)
+{
+    std::cout << std::setw(18) << name << ' ' <<
+        tag_pool<Tag>::instance().stats() << std::endl;
+}
+
+int main(int argc, char* argv[])
+{
+    size_t n = 10'000'000;
+    if (argc > 1)
+        n = std::stoull(argv[1]);
+    run<std::allocator<long>, std::allocator<long>, std::allocator<long>,
+        std::allocator<long>>("std::allocator", n);
+    using shared = pool_allocator<long, shared_pool>;
+    run<shared, shared, shared, shared>("shared pool", n);
+    run<pool_allocator<long, parser_pool>, pool_allocator<long, network_pool>,
+        pool_allocator<long, render_pool>, pool_allocator<long, audio_pool>>(
+            "per-subsystem pools", n);
+    display_stats<shared_pool>("shared");
+    display_stats<parser_pool>("parser");
+    display_stats<network_pool>("network");
+    display_stats<render_pool>("render");
+    display_stats<audio_pool>("audio");
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,169 @@
+#pragma once
+
+/* Memory pools separated by tag types
+ *
+ * tag_pool<Tag> is a singleton pool of small blocks with a free list for
+ * each size class and its own mutex. pool_allocator<T, Tag> is a standard
+ * allocator taking memory from tag_pool<Tag>, typically used by node based
+ * containers, e.g., std::list, std::map, or std::unordered_map. Containers
+ * with different tags never share free lists or locks. A unique tag can be
+ * made by unique from unique_type.hpp without naming it by hand:
+ *
+ *     using parser_pool = unique<pool_tag>;
+ *     std::map<int, int, std::less<>,
+ *              pool_allocator<std::pair<const int, int>, parser_pool>> m;
+ *
+ * Each use of unique is a different type, also when a header containing it
+ * is included in several translation units, each of which would then get
+ * its own pool. Memory allocated in one of them and freed in another would
+ * be mixed into the wrong pool. Hence unique tags must be used only within
+ * one translation unit. A tag shared by several translation units must be
+ * a named type, e.g., struct network_pool: pool_tag {};
+ *
+ * Blocks larger than max_block or aligned to more than granularity bytes,
+ * e.g., arrays of std::vector, are allocated and freed by operator new and
+ * operator delete, and only counted by fallback and fallback_frees. Memory
+ * taken by a pool is returned to its free lists, never to the system.
+ * tag_pool<Tag>::instance().stats() reports usage of a pool.
+ *
+ * Compile with C++20 or higher
+ */
+
+#include "unique_type.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <mutex>
+#include <new>
+#include <ostream>
+#include <type_traits>
+
+// A base of tags, e.g., unique<pool_tag>
+struct pool_tag {};
+
+struct pool_stats {
+    size_t allocations = 0; // of blocks from the pool
+    size_t deallocations = 0; // of blocks to the pool
+    size_t in_use = 0; // bytes in blocks
+    size_t peak = 0; // maximum of in_use
+    size_t reserved = 0; // bytes of chunks taken from operator new
+    size_t fallback = 0; // allocations passed to operator new
+    size_t fallback_frees = 0; // deallocations passed to operator delete
+};
+
+inline std::ostream& operator<<(std::ostream& os, const pool_stats& s)
+{
+    return os << "allocations=" << s.allocations << " deallocations=" <<
+        s.deallocations << " in_use=" << s.in_use << " peak=" << s.peak <<
+        " reserved=" << s.reserved << " fallback=" << s.fallback <<
+        " fallback_frees=" << s.fallback_frees;
+}
+
+// Aligned to a cache line, so that pools of different tags do not share one
+template <class Tag> class alignas(64) tag_pool {
+public:
+    static constexpr size_t granularity = 16;
+    static constexpr size_t max_block = 256;
+    static constexpr size_t chunk_size = 64 * 1024;
+    // Never destroyed, so that containers with static storage duration may
+    // use the pool until the end
+    static tag_pool& instance() {
+        static tag_pool* pool = new tag_pool;
+        return *pool;
+    }
+    tag_pool(const tag_pool&) = delete;
+    tag_pool& operator=(const tag_pool&) = delete;
+    void* allocate(size_t size, size_t align) {
+        if (size > max_block || align > granularity) {
+            {
+                std::lock_guard lck{mtx};
+                ++s.fallback;
+            }
+            return ::operator new(size, std::align_val_t(align));
+        }
+        size_t c = size_class(size);
+        std::lock_guard lck{mtx};
+        block* b = free[c];
+        if (b)
+            free[c] = b->next;
+        else
+            b = carve(c);
+        ++s.allocations;
+        s.in_use += block_size(c);
+        s.peak = std::max(s.peak, s.in_use);
+        return b;
+    }
+    void deallocate(void* p, size_t size, size_t align) noexcept {
+        if (size > max_block || align > granularity) {
+            {
+                std::lock_guard lck{mtx};
+                ++s.fallback_frees;
+            }
+            ::operator delete(p, std::align_val_t(align));
+            return;
+        }
+        size_t c = size_class(size);
+        std::lock_guard lck{mtx};
+        free[c] = new(p) block{free[c]};
+        ++s.deallocations;
+        s.in_use -= block_size(c);
+    }
+    pool_stats stats() {
+        std::lock_guard lck{mtx};
+        return s;
+    }
+private:
+    struct block {
+        block* next;
+    };
+    static constexpr size_t classes = max_block / granularity;
+    tag_pool() = default;
+    static size_t size_class(size_t size) noexcept {
+        return (std::max(size, size_t(1)) + granularity - 1) / granularity - 1;
+    }
+    static size_t block_size(size_t c) noexcept {
+        return (c + 1) * granularity;
+    }
+    // A new block of class c from the current chunk, leaving the rest of the
+    // current chunk unused if it is too small
+    block* carve(size_t c) {
+        size_t bs = block_size(c);
+        if (size_t(end - cur) < bs) {
+            cur = static_cast<std::byte*>(
+                ::operator new(chunk_size, std::align_val_t(granularity)));
+            end = cur + chunk_size;
+            s.reserved += chunk_size;
+        }
+        block* b = new(cur) block{nullptr};
+        cur += bs;
+        return b;
+    }
+    std::mutex mtx;
+    std::array<block*, classes> free{};
+    std::byte* cur = nullptr;
+    std::byte* end = nullptr;
+    pool_stats s;
+};
+
+template <class T, class Tag> class pool_allocator {
+public:
+    using value_type = T;
+    using is_always_equal = std::true_type;
+    pool_allocator() = default;
+    template <class U>
+    pool_allocator(const pool_allocator<U, Tag>&) noexcept {}
+    T* allocate(size_t n) {
+        if (n > size_t(-1) / sizeof(T))
+            throw std::bad_array_new_length();
+        return static_cast<T*>(
+            tag_pool<Tag>::instance().allocate(n * sizeof(T), alignof(T)));
+    }
+    void deallocate(T* p, size_t n) noexcept {
+        tag_pool<Tag>::instance().deallocate(p, n * sizeof(T), alignof(T));
+    }
+    template <class U>
+    bool operator==(const pool_allocator<U, Tag>&) const noexcept {
+        return true;
+    }
+};
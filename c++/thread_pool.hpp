@@ -0,0 +1,130 @@
+#pragma once
+
+/* A fixed set of worker threads running tasks from a shared queue
+ *
+ * Tasks must not throw exceptions. A thread waiting for its tasks can help
+ * by run_one(), so that tasks may wait for other tasks without exhausting
+ * the workers. parallel_for() runs the iterations of a loop as tasks.
+ *
+ * Compile with C++17 or higher
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+class thread_pool {
+public:
+    explicit thread_pool(unsigned threads = std::thread::hardware_concurrency())
+    {
+        threads = std::max(threads, 1u);
+        workers.reserve(threads);
+        for (unsigned i = 0; i < threads; ++i)
+            workers.emplace_back([this] { work(); });
+    }
+    thread_pool(const thread_pool&) = delete;
+    thread_pool& operator=(const thread_pool&) = delete;
+    // Runs the remaining tasks and joins the workers
+    ~thread_pool() {
+        {
+            std::lock_guard lock(mtx);
+            stop = true;
+        }
+        cv.notify_all();
+        for (auto& w: workers)
+            w.join();
+    }
+    size_t size() const noexcept {
+        return workers.size();
+    }
+    void submit(std::function<void()> task) {
+        {
+            std::lock_guard lock(mtx);
+            tasks.push_back(std::move(task));
+        }
+        cv.notify_one();
+    }
+    // Runs a queued task in the calling thread, returns false if there is no
+    // task in the queue
+    bool run_one() {
+        std::function<void()> task;
+        {
+            std::lock_guard lock(mtx);
+            if (tasks.empty())
+                return false;
+            task = std::move(tasks.front());
+            tasks.pop_front();
+        }
+        task();
+        return true;
+    }
+private:
+    void work() {
+        for (;;) {
+            std::function<void()> task;
+            {
+                std::unique_lock lock(mtx);
+                cv.wait(lock, [this] { return stop || !tasks.empty(); });
+                if (tasks.empty())
+                    return;
+                task = std::move(tasks.front());
+                tasks.pop_front();
+            }
+            task();
+        }
+    }
+    std::mutex mtx;
+    std::condition_variable cv;
+    std::deque<std::function<void()>> tasks;
+    bool stop = false;
+    std::vector<std::thread> workers;
+};
+
+// Calls f(i) for i in [0, n), all but f(0) in tasks of the pool, and waits
+// for all of them, helping the pool meanwhile. Rethrows the exception of the
+// lowest i, if any. If submitting a task throws, waits for the tasks already
+// submitted, which refer to local variables, and rethrows.
+template <class F> void parallel_for(thread_pool& pool, size_t n, F&& f)
+{
+    if (n == 0)
+        return;
+    std::vector<std::exception_ptr> errors(n);
+    std::atomic<size_t> remaining(n - 1);
+    auto call = [&f, &errors](size_t i) noexcept {
+        try {
+            f(i);
+        } catch (...) {
+            errors[i] = std::current_exception();
+        }
+    };
+    auto wait = [&pool, &remaining] {
+        while (remaining.load(std::memory_order_acquire) != 0)
+            if (!pool.run_one())
+                std::this_thread::yield();
+    };
+    size_t i = 1;
+    try {
+        for (; i < n; ++i)
+            pool.submit([&call, &remaining, i] {
+                call(i);
+                remaining.fetch_sub(1, std::memory_order_release);
+            });
+    } catch (...) {
+        remaining.fetch_sub(n - i, std::memory_order_relaxed);
+        wait();
+        throw;
+    }
+    call(0);
+    wait();
+    for (auto& e: errors)
+        if (e)
+            std::rethrow_exception(e);
+}
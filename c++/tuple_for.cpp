@@ -1,8 +1,12 @@
-/* Call a visitor for each value in a std::tuple
+/* Call a visitor for each value in a std::tuple, or for a value selected by
+ * an index known only at run time
  *
- * Compile with C++17 or higher
+ * Compile with C++17 or higher on a POSIX system
  */
 
+#include "format_sink.hpp"
+#include "tuple_for.hpp"
+
 #include <array>
 #include <iostream>
 #include <string>
@@ -11,23 +15,14 @@
 #include <utility>
 #include <vector>
 
-template <class F, class T, size_t ...I>
-void tuple_for_impl(F&& f, T&& t, std::index_sequence<I...>)
-{
-    (..., f(std::get<I>(std::forward<T>(t))));
-}
-
-template <class F, class T> void tuple_for(F&& f, T&& t)
-{
-    tuple_for_impl(std::forward<F>(f), std::forward<T>(t),
-                   std::make_index_sequence<std::tuple_size<T>::value>{});
-}
-
-struct display {
+// Writes to std::cout or to another output S, e.g., a format_sink
+template <class S = std::ostream> struct display {
+    display(S& os = std::cout): os(os) {}
     template <class T> void operator()(const T& v) {
-        std::cout << (first ? "" : ", ") << v;
+        os << (first ? "" : ", ") << v;
         first = false;
     }
+    S& os;
     bool first = true;
 };
 
@@ -88,5 +83,14 @@ int main()
         with_size{6} // 6
     }); // 21
     std::cout << sz2.value << std::endl;
+    std::tuple t{'?', 1, 2.0, std::string{"abc"}};
+    for (size_t i = std::tuple_size_v<decltype(t)>; i-- > 0;) {
+        visit_at(t, i, display());
+        std::cout << std::endl;
+    }
+    std::cout.flush();
+    format_sink sink;
+    tuple_for(display(sink), t);
+    sink << '\n';
     return 0;
 }
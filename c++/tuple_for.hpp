@@ -0,0 +1,58 @@
+#pragma once
+
+/* Call a visitor for each value in a std::tuple, or for a value selected by
+ * an index known only at run time
+ *
+ * Compile with C++17 or higher
+ */
+
+#include <array>
+#include <cstddef>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+template <class F, class T, size_t ...I>
+void tuple_for_impl(F&& f, T&& t, std::index_sequence<I...>)
+{
+    (..., f(std::get<I>(std::forward<T>(t))));
+}
+
+template <class F, class T> void tuple_for(F&& f, T&& t)
+{
+    tuple_for_impl(std::forward<F>(f), std::forward<T>(t),
+                   std::make_index_sequence<
+                       std::tuple_size<std::decay_t<T>>::value>{});
+}
+
+template <class F, class T, size_t I> using visit_result_t =
+    std::invoke_result_t<F, decltype(std::get<I>(std::declval<T>()))>;
+
+template <class T, class F, size_t ...I>
+decltype(auto) visit_at_impl(T&& t, size_t i, F&& f, std::index_sequence<I...>)
+{
+    using r_type = visit_result_t<F, T, 0>;
+    static_assert((... && std::is_same_v<r_type, visit_result_t<F, T, I>>),
+                  "visitor must return the same type for all elements");
+    using fun_t = r_type (*)(T&&, F&&);
+    static constexpr std::array<fun_t, sizeof...(I)> table{
+        [](T&& t, F&& f) -> r_type {
+            return std::forward<F>(f)(std::get<I>(std::forward<T>(t)));
+        }...
+    };
+    if (i >= sizeof...(I))
+        throw std::out_of_range("visit_at: tuple index out of range");
+    return table[i](std::forward<T>(t), std::forward<F>(f));
+}
+
+// Calls f(std::get<i>(t)) by a single indirect call via a table of functions
+// generated for all indices. Throws std::out_of_range if i is not a valid
+// index.
+template <class T, class F> decltype(auto) visit_at(T&& t, size_t i, F&& f)
+{
+    constexpr size_t n = std::tuple_size_v<std::decay_t<T>>;
+    static_assert(n > 0, "cannot visit an element of an empty tuple");
+    return visit_at_impl(std::forward<T>(t), i, std::forward<F>(f),
+                         std::make_index_sequence<n>{});
+}
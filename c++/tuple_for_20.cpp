@@ -1,8 +1,10 @@
 /* Call a visitor for each value in a std::tuple
  *
- * Compile with C++20 or higher
+ * Compile with C++20 or higher on a POSIX system
  */
 
+#include "format_sink.hpp"
+
 #include <iostream>
 #include <sstream>
 #include <tuple>
@@ -30,25 +32,27 @@ template <class T, class F> void for_each(T&& t, F&& f)
       std::make_index_sequence<std::tuple_size_v<std::decay_t<T>>>{});
 }
 
-struct out {
-    out() {
-        std::cout << '{';
+// Writes a tuple to std::cout or to another output S, e.g., a format_sink
+template <class S = std::ostream> struct out {
+    out(S& os = std::cout): os(os) {
+        os << '{';
     }
     ~out() {
-        std::cout << "}\n";
+        os << "}\n";
     }
     template <class T> static constexpr bool printable =
-        requires(T v) {
-            std::cout << v;
+        requires(S& os, T v) {
+            os << v;
         };
     template <class T> void operator()(T&& v) requires printable<T> {
-        std::cout << d << v;
+        os << d << v;
         d = ",";
     };
     template <class T> void operator()(T&&) requires (!printable<T>) {
-        std::cout << d << '?';
+        os << d << '?';
         d = ",";
     };
+    S& os;
     std::string_view d = "";
 };
 
@@ -56,6 +60,10 @@ template <class T> void out_tuple(T&& t) {
     for_each(std::forward<T>(t), out{});
 }
 
+template <class T> void out_tuple(T&& t, format_sink& sink) {
+    for_each(std::forward<T>(t), out{sink});
+}
+
 int main(int argc, char* argv[])
 {
     std::ostringstream save;
@@ -68,5 +76,11 @@ int main(int argc, char* argv[])
     out_tuple(std::tuple{"abc", "d", 1.23e25, &main, 'x', false});
     std::cout.copyfmt(save);
     out_tuple(std::tuple{"abc", "d", 1.23e25, &main, 'x', false});
+    std::cout.flush();
+    format_sink sink;
+    sink.boolalpha = true;
+    out_tuple(std::make_tuple(), sink);
+    out_tuple(std::make_tuple(true, std::vector<int>{}), sink);
+    out_tuple(std::tuple{"abc", "d", 1.23e25, &save, 'x', false}, sink);
     return EXIT_SUCCESS;
 }
@@ -0,0 +1,128 @@
+/* Visiting an element of a std::tuple selected by an index known only at run
+ * time by visit_at() from tuple_for.hpp, which uses a table of functions,
+ * compared to a linear chain of comparisons of the index
+ *
+ * Usage: tuple_visit_at [visits [repeat]]
+ *
+ * Compile time is measured by tuple_visit_at.sh, which compiles this file
+ * with VISIT_AT_N (the tuple size) and VISIT_AT_METHOD (run_table or
+ * run_linear) defined, so that only a single variant is instantiated.
+ *
+ * Compile with C++17 or higher
+ */
+
+#include "bench.hpp"
+#include "tuple_for.hpp"
+
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+template <size_t I> struct elem {
+    unsigned long long v = I;
+};
+
+template <size_t ...I> auto make_tuple(std::index_sequence<I...>)
+{
+    return std::tuple<elem<I>...>{};
+}
+
+template <size_t N>
+using tuple_n = decltype(make_tuple(std::make_index_sequence<N>{}));
+
+template <class T, class F, size_t ...I>
+void visit_linear_impl(T&& t, size_t i, F&& f, std::index_sequence<I...>)
+{
+    if (!(... || (i == I ? (f(std::get<I>(std::forward<T>(t))), true) :
+                  false)))
+    {
+        throw std::out_of_range("visit_linear: tuple index out of range");
+    }
+}
+
+// Tests the index against all valid indices one after another
+template <class T, class F> void visit_linear(T&& t, size_t i, F&& f)
+{
+    visit_linear_impl(std::forward<T>(t), i, std::forward<F>(f),
+        std::make_index_sequence<std::tuple_size_v<std::decay_t<T>>>{});
+}
+
+struct add {
+    template <class T> void operator()(const T& v) {
+        sum += v.v;
+    }
+    unsigned long long& sum;
+};
+
+template <size_t N>
+double run_table(const std::vector<size_t>& idx, size_t repeat,
+                 unsigned long long& sum)
+{
+    tuple_n<N> t;
+    return bench::ns_per_op("visit_at elements=" + std::to_string(N), repeat,
+                            [&](size_t) {
+        for (auto i: idx)
+            visit_at(t, i, add{sum});
+    }) / double(idx.size());
+}
+
+template <size_t N>
+double run_linear(const std::vector<size_t>& idx, size_t repeat,
+                  unsigned long long& sum)
+{
+    tuple_n<N> t;
+    return bench::ns_per_op("linear elements=" + std::to_string(N), repeat,
+                            [&](size_t) {
+        for (auto i: idx)
+            visit_linear(t, i, add{sum});
+    }) / double(idx.size());
+}
+
+template <size_t N> void run(size_t n, size_t repeat)
+{
+    std::mt19937 rnd{};
+    std::uniform_int_distribution<size_t> dist(0, N - 1);
+    std::vector<size_t> idx(n);
+    for (auto& i: idx)
+        i = dist(rnd);
+    unsigned long long sum_table = 0;
+    unsigned long long sum_linear = 0;
+    double ns_table = run_table<N>(idx, repeat, sum_table);
+    double ns_linear = run_linear<N>(idx, repeat, sum_linear);
+    std::cout << "elements=" << std::setw(3) << N << std::fixed <<
+        std::setprecision(2) << " visit_at ns/visit=" << ns_table <<
+        " linear ns/visit=" << ns_linear << std::defaultfloat <<
+        (sum_table == sum_linear ? "" : " different results") << std::endl;
+}
+
+int main(int argc, char* argv[])
+{
+    size_t n = 1'000'000;
+    size_t repeat = 10;
+    if (argc > 1)
+        n = std::stoull(argv[1]);
+    if (argc > 2)
+        repeat = std::stoull(argv[2]);
+#ifdef VISIT_AT_N
+    std::vector<size_t> idx(n, VISIT_AT_N - 1);
+    unsigned long long sum = 0;
+    std::cout << "elements=" << VISIT_AT_N << " ns/visit=" <<
+        VISIT_AT_METHOD<VISIT_AT_N>(idx, repeat, sum) << std::endl;
+#else
+    run<4>(n, repeat);
+    run<8>(n, repeat);
+    run<16>(n, repeat);
+    run<32>(n, repeat);
+    run<64>(n, repeat);
+    run<128>(n, repeat);
+    run<256>(n, repeat);
+#endif
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,23 @@
+#!/bin/bash
+
+# Compile time of visit_at() and of a linear chain of comparisons for various
+# tuple sizes, see tuple_visit_at.cpp
+#
+# Usage: tuple_visit_at.sh [compiler [flags...]]
+#   The default is g++ -std=c++17 -O2
+
+set -e
+cd "$(dirname "$0")"
+if [ $# -gt 0 ]; then
+    cxx=("$@")
+else
+    cxx=(g++ -std=c++17 -O2)
+fi
+TIMEFORMAT=%R
+for n in 4 8 16 32 64 128 256; do
+    for m in run_table run_linear; do
+        t=$( { time "${cxx[@]}" -c -o /dev/null -DVISIT_AT_N=$n \
+            -DVISIT_AT_METHOD=$m tuple_visit_at.cpp; } 2>&1 )
+        echo "elements=$n method=$m seconds=$t"
+    done
+done
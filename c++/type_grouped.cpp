@@ -0,0 +1,121 @@
+/* Visiting millions of objects of mixed types stored in type_grouped compared
+ * to std::vector<std::any> with visitors in std::unordered_map (as in
+ * std_any.cpp) and to std::vector<typed_any> with a dispatcher (as in
+ * any_dispatch.cpp)
+ *
+ * Usage: type_grouped [elements [repeat]]
+ *
+ * Compile with C++20 or higher
+ */
+
+#include "any_dispatch.hpp"
+#include "any_visitor.hpp"
+#include "bench.hpp"
+#include "type_grouped.hpp"
+
+#include <any>
+#include <array>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <string_view>
+#include <typeindex>
+#include <typeinfo>
+#include <utility>
+#include <vector>
+
+struct small {
+    unsigned long long v;
+};
+
+struct medium {
+    double d;
+    unsigned long long v;
+};
+
+struct big {
+    std::array<unsigned long long, 16> a;
+    unsigned long long v;
+};
+
+using any_dispatch::dispatcher;
+using any_dispatch::typed_any;
+using grouped = type_grouped<small, medium, big>;
+
+unsigned long long sum = 0;
+
+void display(std::string_view name, size_t n, double ns)
+{
+    std::cout << std::setw(28) << name << " elements=" << n << std::fixed <<
+        std::setprecision(2) << " ns/element=" << ns / n <<
+        std::defaultfloat << std::endl;
+}
+
+int main(int argc, char* argv[])
+{
+    size_t n = 3'000'000;
+    size_t repeat = 10;
+    if (argc > 1)
+        n = std::stoull(argv[1]);
+    if (argc > 2)
+        repeat = std::stoull(argv[2]);
+    std::vector<std::any> anys;
+    std::vector<typed_any> typed;
+    grouped g;
+    std::mt19937 rnd{};
+    std::uniform_int_distribution<int> dist(0, 2);
+    for (unsigned long long i = 0; i < n; ++i)
+        switch (dist(rnd)) {
+        case 0:
+            anys.push_back(small{i});
+            typed.push_back(small{i});
+            g.push_back(small{i});
+            break;
+        case 1:
+            anys.push_back(medium{0.0, i});
+            typed.push_back(medium{0.0, i});
+            g.push_back(medium{0.0, i});
+            break;
+        default:
+            anys.push_back(big{{}, i});
+            typed.push_back(big{{}, i});
+            g.push_back(big{{}, i});
+            break;
+        }
+    auto add_v = [](const std::any&, const auto& v) { sum += v.v; };
+    any_visitor_map visitors{
+        make_any_visitor<small>(add_v),
+        make_any_visitor<medium>(add_v),
+        make_any_visitor<big>(add_v),
+    };
+    dispatcher disp{[](const std::any&) {}};
+    disp.add<small>(add_v).add<medium>(add_v).add<big>(add_v);
+    auto add_i = [](size_t, const auto& v) { sum += v.v; };
+
+    auto run = [n, repeat](std::string_view method, auto f) {
+        display(method, n, bench::ns_per_op(method, repeat, f));
+    };
+    run("vector<any> unordered_map", [&](size_t) {
+        for (auto& a: anys)
+            visitors.find(std::type_index(a.type()))->second(a);
+    });
+    run("vector<typed_any> dispatcher", [&](size_t) {
+        for (auto& a: typed)
+            disp(a);
+    });
+    run("type_grouped visit", [&](size_t) {
+        g.visit(make_group_visitor<small>(add_i),
+                make_group_visitor<medium>(add_i),
+                make_group_visitor<big>(add_i));
+    });
+    run("type_grouped visit_all", [&](size_t) {
+        g.visit_all(add_i);
+    });
+    run("type_grouped visit_in_order", [&](size_t) {
+        g.visit_in_order(add_i);
+    });
+    std::cout << "sum=" << sum << std::endl;
+    return EXIT_SUCCESS;
+}
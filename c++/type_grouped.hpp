@@ -0,0 +1,142 @@
+#pragma once
+
+/* A heterogeneous container of objects of types T..., which stores objects of
+ * each type in a separate contiguous std::vector
+ *
+ * Visiting all elements goes type by type, so that it accesses memory
+ * sequentially and does not need a type lookup for each element. The order of
+ * insertion is recorded in an index and can be restored.
+ *
+ * Compile with C++20 or higher
+ */
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// A visitor of elements of type T, in the style of make_any_visitor() in
+// any_visitor.hpp. It is called as f(i, v), where i is the position of v in
+// the order of insertion.
+template <class T, class F> struct group_visitor {
+    using type = T;
+    F f;
+};
+
+template <class T, class F> group_visitor<T, F> make_group_visitor(F f)
+{
+    return {std::move(f)};
+}
+
+template <class ...T> class type_grouped {
+public:
+    // Type and position in the group of an element. Positions are 32-bit to
+    // keep the index small, so a group holds at most max_group_size elements.
+    static constexpr size_t max_group_size = UINT32_MAX;
+    struct entry {
+        uint32_t type;
+        uint32_t pos;
+    };
+    template <class U> static constexpr size_t type_index = []{
+        constexpr std::array is{std::is_same_v<U, T>...};
+        size_t i = 0;
+        while (i < is.size() && !is[i])
+            ++i;
+        return i;
+    }();
+    // Returns the position of the new element in the order of insertion
+    template <class U> size_t push_back(U&& v) {
+        emplace_back<std::decay_t<U>>(std::forward<U>(v));
+        return order.size() - 1;
+    }
+    template <class U, class ...A> U& emplace_back(A&& ...a) {
+        static_assert(type_index<U> < sizeof...(T), "type not in T...");
+        auto& g = std::get<type_index<U>>(groups);
+        if (g.values.size() >= max_group_size)
+            throw std::length_error("type_grouped group too large");
+        U& v = g.values.emplace_back(std::forward<A>(a)...);
+        try {
+            g.positions.push_back(order.size());
+            order.push_back({uint32_t(type_index<U>),
+                             uint32_t(g.values.size() - 1)});
+        } catch (...) {
+            if (g.positions.size() == g.values.size())
+                g.positions.pop_back();
+            g.values.pop_back();
+            throw;
+        }
+        return v;
+    }
+    size_t size() const noexcept {
+        return order.size();
+    }
+    bool empty() const noexcept {
+        return order.empty();
+    }
+    void clear() noexcept {
+        std::apply([](auto& ...g) { (..., g.clear()); }, groups);
+        order.clear();
+    }
+    template <class U> void reserve(size_t n) {
+        auto& g = std::get<type_index<U>>(groups);
+        g.values.reserve(n);
+        g.positions.reserve(n);
+    }
+    // Elements of type U in the order of insertion
+    template <class U> std::span<const U> group() const noexcept {
+        return std::get<type_index<U>>(groups).values;
+    }
+    template <class U> std::span<U> group() noexcept {
+        return std::get<type_index<U>>(groups).values;
+    }
+    // Where is the i-th inserted element
+    entry at(size_t i) const noexcept {
+        return order[i];
+    }
+    // Visits groups by visitors created by make_group_visitor(). Groups
+    // without a visitor are skipped.
+    template <class ...V> void visit(V&& ...visitors) const {
+        (..., visit_group(visitors));
+    }
+    // Visits all groups by a generic visitor called as f(i, v)
+    template <class F> void visit_all(F&& f) const {
+        std::apply([&f](auto& ...g) { (..., visit_group(g, f)); }, groups);
+    }
+    // Visits all elements in the order of insertion, each element requires
+    // dispatching by its type
+    template <class F> void visit_in_order(F&& f) const {
+        using fun_t = void (*)(const type_grouped&, size_t, uint32_t, F&);
+        static constexpr std::array<fun_t, sizeof...(T)> table{
+            [](const type_grouped& self, size_t i, uint32_t pos, F& f) {
+                f(i, std::get<type_index<T>>(self.groups).values[pos]);
+            }...
+        };
+        for (size_t i = 0; i < order.size(); ++i)
+            table[order[i].type](*this, i, order[i].pos, f);
+    }
+private:
+    template <class U> struct storage {
+        void clear() noexcept {
+            values.clear();
+            positions.clear();
+        }
+        std::vector<U> values;
+        std::vector<size_t> positions;
+    };
+    template <class U, class F>
+    static void visit_group(const storage<U>& g, F& f) {
+        for (size_t i = 0; i < g.values.size(); ++i)
+            f(g.positions[i], g.values[i]);
+    }
+    template <class U, class F>
+    void visit_group(const group_visitor<U, F>& v) const {
+        visit_group(std::get<type_index<U>>(groups), v.f);
+    }
+    std::tuple<storage<T>...> groups;
+    std::vector<entry> order;
+};
@@ -3,16 +3,14 @@
  * Compile with C++20 or higher
  */
 
+#include "unique_type.hpp"
+
 #include <type_traits>
 
 template <class T> struct same {
     T val;
 };
 
-template <class T, auto = []{}> struct unique {
-    T val;
-};
-
 using same1 = same<int>;
 using same2 = same<int>;
 static_assert(std::is_same_v<same1, same2>);
@@ -0,0 +1,10 @@
+#pragma once
+
+/* A template that generates a unique type on each use
+ *
+ * Compile with C++20 or higher
+ */
+
+template <class T, auto = []{}> struct unique {
+    T val;
+};
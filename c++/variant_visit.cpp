@@ -0,0 +1,147 @@
+/* table_visit and switch_visit from variant_visit.hpp compared to std::visit
+ * for variants with 2 to 64 alternatives, with uniformly distributed
+ * alternatives and with 90 % of values of the first alternative
+ *
+ * Usage: variant_visit [visits]
+ *   The default number of visits of each combination is 10^8.
+ *
+ * Compile with C++17 or higher
+ */
+
+#include "bench.hpp"
+#include "overloaded.hpp"
+#include "variant_visit.hpp"
+
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <variant>
+#include <vector>
+
+template <size_t I> struct alt {
+    int v;
+};
+
+template <size_t ...I> auto make_variant(std::index_sequence<I...>)
+{
+    return std::variant<alt<I>...>{};
+}
+
+template <size_t ...I> auto make_visitor(std::index_sequence<I...>)
+{
+    return overloaded{[](const alt<I>& a) { return long(a.v) * (I + 1); }...};
+}
+
+// Creates an alternative selected by an index known only at run time
+template <class V, size_t ...I>
+V make_alternative(size_t i, int v, std::index_sequence<I...>)
+{
+    V r;
+    (..., (i == I ? void(r = alt<I>{v}) : void()));
+    return r;
+}
+
+void display(size_t alternatives, std::string_view distribution,
+             std::string_view method, double ns, long sum)
+{
+    std::cout << "alternatives=" << std::setw(2) << alternatives <<
+        std::setw(8) << distribution << std::setw(13) << method <<
+        std::fixed << std::setprecision(3) << " ns/visit=" << ns <<
+        std::defaultfloat << " sum=" << sum << std::endl;
+}
+
+// Visits variants in v repeatedly, visits times in total, and displays the
+// time of a visit
+template <class V, class F>
+void run(size_t alternatives, std::string_view distribution,
+         std::string_view method, const std::vector<V>& v, size_t visits,
+         F visit)
+{
+    size_t repeat = (visits + v.size() - 1) / v.size();
+    auto name = "alternatives=" + std::to_string(alternatives) + ' ' +
+        std::string(distribution) + ' ' + std::string(method);
+    long s = 0;
+    double ns = bench::ns_per_op(name, repeat, [&v, &visit, &s](size_t) {
+        for (auto& e: v)
+            s += visit(e);
+        bench::do_not_optimize(s);
+    });
+    display(alternatives, distribution, method, ns / v.size(), s);
+}
+
+template <size_t N> void run_alternatives(size_t visits)
+{
+    using seq = std::make_index_sequence<N>;
+    using variant = decltype(make_variant(seq{}));
+    auto visitor = make_visitor(seq{});
+    constexpr size_t size = 1 << 20;
+    std::mt19937 gen(1);
+    for (std::string_view distribution: {"uniform", "skewed"}) {
+        std::uniform_int_distribution<size_t> uniform(0, N - 1);
+        std::bernoulli_distribution first(0.9);
+        std::vector<variant> v;
+        v.reserve(size);
+        for (size_t i = 0; i < size; ++i) {
+            size_t a = distribution == "skewed" && first(gen) ? 0 : uniform(gen);
+            v.push_back(make_alternative<variant>(a, int(i % 100), seq{}));
+        }
+        run(N, distribution, "std::visit", v, visits,
+            [&visitor](const variant& e) {
+                return std::visit(visitor, e);
+            });
+        run(N, distribution, "table_visit", v, visits,
+            [&visitor](const variant& e) {
+                return table_visit(visitor, e);
+            });
+        if constexpr (N <= switch_visit_max) {
+            run(N, distribution, "switch_visit", v, visits,
+                [&visitor](const variant& e) {
+                    return switch_visit(visitor, e);
+                });
+        }
+    }
+}
+
+// Visitation of pairs of variants
+void run_pairs(size_t visits)
+{
+    using seq = std::make_index_sequence<8>;
+    using variant = decltype(make_variant(seq{}));
+    using pair = std::pair<variant, variant>;
+    auto visitor = [](const auto& a, const auto& b) { return long(a.v - b.v); };
+    constexpr size_t size = 1 << 20;
+    std::mt19937 gen(1);
+    std::uniform_int_distribution<size_t> uniform(0, 7);
+    std::vector<pair> v;
+    v.reserve(size);
+    for (size_t i = 0; i < size; ++i)
+        v.emplace_back(make_alternative<variant>(uniform(gen), int(i % 100),
+                                                 seq{}),
+                       make_alternative<variant>(uniform(gen), int(i % 7),
+                                                 seq{}));
+    run(8 * 8, "pairs", "std::visit", v, visits, [&visitor](const pair& p) {
+        return std::visit(visitor, p.first, p.second);
+    });
+    run(8 * 8, "pairs", "table_visit", v, visits, [&visitor](const pair& p) {
+        return table_visit(visitor, p.first, p.second);
+    });
+}
+
+int main(int argc, char* argv[])
+{
+    size_t visits = 100'000'000;
+    if (argc > 1)
+        visits = std::stoull(argv[1]);
+    run_alternatives<2>(visits);
+    run_alternatives<4>(visits);
+    run_alternatives<8>(visits);
+    run_alternatives<16>(visits);
+    run_alternatives<32>(visits);
+    run_alternatives<64>(visits);
+    run_pairs(visits);
+    return EXIT_SUCCESS;
+}
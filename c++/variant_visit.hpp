@@ -0,0 +1,130 @@
+#pragma once
+
+/* Visiting std::variant objects by a visitor, usually overloaded from
+ * overloaded.hpp, like std::visit
+ *
+ * table_visit(f, v...) calls f via a flat table of function pointers,
+ * indexed by a combination of v.index()... of one or more variants.
+ * switch_visit(f, v) dispatches by a switch statement on v.index() of
+ * a single variant with at most switch_visit_max alternatives, which the
+ * compiler can inline. fast_visit(f, v...) selects one of them.
+ *
+ * The visitor must return the same type for all combinations of
+ * alternatives. A variant valueless by exception causes
+ * std::bad_variant_access.
+ *
+ * Compile with C++17 or higher
+ */
+
+#include <array>
+#include <cstddef>
+#include <functional>
+#include <type_traits>
+#include <utility>
+#include <variant>
+
+template <class ...V> struct variant_shape {
+    static constexpr std::array<size_t, sizeof...(V)> sizes{
+        std::variant_size_v<std::remove_cv_t<std::remove_reference_t<V>>>...
+    };
+    static constexpr size_t combinations =
+        (size_t(1) * ... *
+         std::variant_size_v<std::remove_cv_t<std::remove_reference_t<V>>>);
+    // The index of the alternative of the k-th variant in combination j
+    static constexpr size_t digit(size_t j, size_t k) {
+        for (size_t m = k + 1; m < sizes.size(); ++m)
+            j /= sizes[m];
+        return j % sizes[k];
+    }
+};
+
+template <class F, class ...V> using variant_visit_result_t =
+    std::invoke_result_t<F, decltype(std::get<0>(std::declval<V>()))...>;
+
+template <size_t J, class R, class F, class ...V, size_t ...K>
+R variant_visit_entry_impl(std::index_sequence<K...>, F&& f, V&& ...v)
+{
+    using shape = variant_shape<V...>;
+    using r_type = decltype(std::invoke(std::forward<F>(f),
+        std::get<shape::digit(J, K)>(std::forward<V>(v))...));
+    static_assert(std::is_same_v<R, r_type>,
+                  "visitor must return the same type for all alternatives");
+    return std::invoke(std::forward<F>(f),
+                       std::get<shape::digit(J, K)>(std::forward<V>(v))...);
+}
+
+template <size_t J, class R, class F, class ...V>
+R variant_visit_entry(F&& f, V&& ...v)
+{
+    return variant_visit_entry_impl<J, R>(std::index_sequence_for<V...>{},
+                                          std::forward<F>(f),
+                                          std::forward<V>(v)...);
+}
+
+template <class R, class F, class ...V, size_t ...J>
+constexpr auto make_variant_visit_table(std::index_sequence<J...>)
+{
+    return std::array<R (*)(F&&, V&&...), sizeof...(J)>{
+        &variant_visit_entry<J, R, F, V...>...
+    };
+}
+
+template <class F, class ...V> decltype(auto) table_visit(F&& f, V&& ...v)
+{
+    static_assert(sizeof...(V) > 0, "nothing to visit");
+    using shape = variant_shape<V...>;
+    using r_type = variant_visit_result_t<F, V...>;
+    static constexpr auto table = make_variant_visit_table<r_type, F, V...>(
+        std::make_index_sequence<shape::combinations>{});
+    if ((... || v.valueless_by_exception()))
+        throw std::bad_variant_access();
+    size_t j = 0;
+    size_t k = 0;
+    (..., (j = j * shape::sizes[k++] + v.index()));
+    return table[j](std::forward<F>(f), std::forward<V>(v)...);
+}
+
+inline constexpr size_t switch_visit_max = 16;
+
+template <class F, class V> decltype(auto) switch_visit(F&& f, V&& v)
+{
+    constexpr size_t n = variant_shape<V>::combinations;
+    static_assert(n <= switch_visit_max, "too many alternatives for switch");
+    using r_type = variant_visit_result_t<F, V>;
+    switch (v.index()) {
+#define SWITCH_VISIT_CASE(i) \
+    case i: \
+        if constexpr (i < n) \
+            return variant_visit_entry<i, r_type>(std::forward<F>(f), \
+                                                  std::forward<V>(v)); \
+        break;
+    SWITCH_VISIT_CASE(0)
+    SWITCH_VISIT_CASE(1)
+    SWITCH_VISIT_CASE(2)
+    SWITCH_VISIT_CASE(3)
+    SWITCH_VISIT_CASE(4)
+    SWITCH_VISIT_CASE(5)
+    SWITCH_VISIT_CASE(6)
+    SWITCH_VISIT_CASE(7)
+    SWITCH_VISIT_CASE(8)
+    SWITCH_VISIT_CASE(9)
+    SWITCH_VISIT_CASE(10)
+    SWITCH_VISIT_CASE(11)
+    SWITCH_VISIT_CASE(12)
+    SWITCH_VISIT_CASE(13)
+    SWITCH_VISIT_CASE(14)
+    SWITCH_VISIT_CASE(15)
+#undef SWITCH_VISIT_CASE
+    }
+    throw std::bad_variant_access();
+}
+
+template <class F, class ...V> decltype(auto) fast_visit(F&& f, V&& ...v)
+{
+    if constexpr (sizeof...(V) == 1 &&
+                  variant_shape<V...>::combinations <= switch_visit_max)
+    {
+        return switch_visit(std::forward<F>(f), std::forward<V>(v)...);
+    } else
+        return table_visit(std::forward<F>(f), std::forward<V>(v)...);
+}